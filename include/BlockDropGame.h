@@ -1,47 +1,151 @@
 #pragma once
 #include <vector>
 #include <array>
-#include <random>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <type_traits>
 
-class BlockDropGame {
+class Evaluator;
+
+// Board geometries compiled into the game, as X(width, height). Every
+// template over the geometry is explicitly instantiated for exactly these.
+#define BLOCKDROP_GEOMETRIES(X) \
+    X(10, 20) X(10, 40) X(12, 20) X(12, 40) \
+    X(16, 20) X(16, 40) X(32, 20) X(32, 40)
+
+// Everything that does not depend on the board size: the piece set and the
+// auto-play search types
+class BlockDropRules {
 public:
-    static const int BOARD_WIDTH = 10;
-    static const int BOARD_HEIGHT = 20;
     static const int PIECE_SIZE = 5;
-    
+
     enum class TetrominoType {
         I = 0, O, T, S, Z, J, L, COUNT
     };
-    
+
     struct Tetromino {
         std::vector<std::array<std::string, PIECE_SIZE>> rotations;
     };
 
+    // Board measurements the auto-play evaluation is built from
+    struct BoardFeatures {
+        int maxHeight;
+        int aggregateHeight;
+        int completeLines;
+        int holes;
+        int bumpiness;
+        int totalTiles;
+        int nearlyCompleteRows;
+        int emptyColumns;
+    };
+    static const int FEATURE_COUNT = 8;
+
+    // Selects BoardFeatures members, one bit each in member order
+    enum FeatureBit : uint32_t {
+        FEATURE_MAX_HEIGHT = 1u << 0,
+        FEATURE_AGGREGATE_HEIGHT = 1u << 1,
+        FEATURE_COMPLETE_LINES = 1u << 2,
+        FEATURE_HOLES = 1u << 3,
+        FEATURE_BUMPINESS = 1u << 4,
+        FEATURE_TOTAL_TILES = 1u << 5,
+        FEATURE_NEARLY_COMPLETE_ROWS = 1u << 6,
+        FEATURE_EMPTY_COLUMNS = 1u << 7
+    };
+    static const uint32_t ALL_FEATURES = (1u << FEATURE_COUNT) - 1;
+
+    // One placement the auto-play search considered: drop at x with rotation
+    struct MoveCandidate {
+        int x;
+        int rotation;
+        BoardFeatures features;
+        double score;
+    };
+
+    // xorshift64*: the whole generator is one word of POD state, never zero
+    static uint32_t nextRandom(uint64_t& rngState);
+    static TetrominoType randomPiece(uint64_t& rngState);
+    static int rotationCount(TetrominoType type) {
+        return static_cast<int>(tetrominoes[static_cast<int>(type)].rotations.size());
+    }
+    static int lineClearScore(int linesCleared, int level) { return linesCleared * 100 * level; }
+    static double fallSpeedForLevel(int level);
+
+protected:
+    static const int PIECE_COUNT = static_cast<int>(TetrominoType::COUNT);
+    static const int MAX_ROTATIONS = 4;
+
+    // Occupied columns of each row of one rotation, bit x = column x of the piece box
+    struct PieceMask {
+        std::array<uint8_t, PIECE_SIZE> rows;
+    };
+
+    // Piece shapes never change, so every game shares one table
+    static const std::array<Tetromino, PIECE_COUNT> tetrominoes;
+    static const std::array<std::array<PieceMask, MAX_ROTATIONS>, PIECE_COUNT> pieceMasks;
+
+    static std::array<Tetromino, PIECE_COUNT> createTetrominoes();
+    static std::array<std::array<PieceMask, MAX_ROTATIONS>, PIECE_COUNT> createPieceMasks();
+};
+
+// Narrowest unsigned integer holding one bit per column
+template <int Width>
+using RowMaskFor = std::conditional_t<(Width <= 8), uint8_t,
+                   std::conditional_t<(Width <= 16), uint16_t, uint32_t>>;
+
+template <int Width, int Height>
+class BasicBlockDropGame : public BlockDropRules {
+    static_assert(Width >= PIECE_SIZE && Width <= 32, "Rows are stored as masks of at most 32 bits");
+    static_assert(Height >= PIECE_SIZE && Height <= 64, "The stream protocol carries at most 64 rows");
+
+public:
+    static const int BOARD_WIDTH = Width;
+    static const int BOARD_HEIGHT = Height;
+    static const int SPAWN_X = Width / 2 - 2;
+
+    using RowMask = RowMaskFor<Width>;
+    static constexpr RowMask FULL_ROW = static_cast<RowMask>((uint64_t(1) << Width) - 1);
+
+    // Cell values: 0 = empty, 1-7 = placed piece of TetrominoType value - 1
+    using Board = std::array<std::array<uint8_t, Width>, Height>;
+    // Occupancy of each row, bit x = column x
+    using Rows = std::array<RowMask, Height>;
+
+    // All mutable game state in one trivially copyable block, so a game can be
+    // saved and restored with a single memcpy
+    struct State {
+        Board board;
+        Rows rows;          // Mirrors board; collisions and line clears use these
+        uint64_t rngState;  // xorshift64* state, never zero
+
+        double fallTime;
+        double fallSpeed;
+        double autoTimer;  // Timer for auto-play step intervals
+
+        TetrominoType currentPiece;
+        int currentX, currentY;
+        int currentRotation;
+
+        int score;
+        int level;
+        int linesCleared;
+
+        int targetX, targetRotation;  // Cache target position to avoid recalculation
+        bool gameOver;
+        bool autoPlay;
+        bool autoPlayPositioned;  // True when auto-play has reached target position and rotation
+    };
+    static_assert(std::is_trivially_copyable<State>::value, "State must stay memcpy-able");
+
 private:
-    std::vector<std::vector<int>> board;
-    std::array<Tetromino, static_cast<int>(TetrominoType::COUNT)> tetrominoes;
-    
-    TetrominoType currentPiece;
-    int currentX, currentY;
-    int currentRotation;
-    
-    int score;
-    int level;
-    int linesCleared;
-    bool gameOver;
-    
-    double fallTime;
-    double fallSpeed;
-    bool autoPlay;
-    bool autoPlayPositioned;  // True when auto-play has reached target position and rotation
-    int targetX, targetRotation;  // Cache target position to avoid recalculation
-    double autoTimer;  // Timer for auto-play step intervals
-    
-    std::mt19937 rng;
-    
+    State state;
+    mutable std::vector<MoveCandidate> candidates;  // Search scratch, reused between moves
+    std::shared_ptr<const Evaluator> evaluator;      // nullptr = built-in heuristic
+
 public:
-    BlockDropGame();
-    
+    BasicBlockDropGame();
+    explicit BasicBlockDropGame(uint64_t seed);
+
     void newPiece();
     bool checkCollision(int dx = 0, int dy = 0, int rotation = -1) const;
     void placePiece();
@@ -50,28 +154,78 @@ public:
     void rotatePiece();
     void dropPiece();
     void hardDrop();
-    
+
     void update(double deltaTime);
     void handleInput(char key);
-    
+
     // Getters
-    const std::vector<std::vector<int>>& getBoard() const { return board; }
+    const Board& getBoard() const { return state.board; }
+    const Rows& getRows() const { return state.rows; }
     const std::array<std::string, PIECE_SIZE>& getCurrentPieceShape() const;
-    TetrominoType getCurrentPieceType() const { return currentPiece; }
-    int getCurrentX() const { return currentX; }
-    int getCurrentY() const { return currentY; }
-    int getScore() const { return score; }
-    int getLevel() const { return level; }
-    int getLinesCleared() const { return linesCleared; }
-    bool isGameOver() const { return gameOver; }
-    bool isAutoPlay() const { return autoPlay; }
-    
-    void toggleAutoPlay() { autoPlay = !autoPlay; }
-    
+    TetrominoType getCurrentPieceType() const { return state.currentPiece; }
+    int getCurrentX() const { return state.currentX; }
+    int getCurrentY() const { return state.currentY; }
+    int getCurrentRotation() const { return state.currentRotation; }
+    int getScore() const { return state.score; }
+    int getLevel() const { return state.level; }
+    int getLinesCleared() const { return state.linesCleared; }
+    bool isGameOver() const { return state.gameOver; }
+    bool isAutoPlay() const { return state.autoPlay; }
+
+    void toggleAutoPlay() { state.autoPlay = !state.autoPlay; }
+
+    // Snapshots
+    const State& getState() const { return state; }
+    void saveState(State& out) const;
+    void restoreState(const State& in);
+    bool saveCheckpoint(const std::string& path) const;
+    bool loadCheckpoint(const std::string& path);
+
+    // Scores auto-play candidates with `evaluator` instead of the built-in
+    // heuristic; nullptr restores the heuristic. Not part of State.
+    void setEvaluator(std::shared_ptr<const Evaluator> evaluator) { this->evaluator = std::move(evaluator); }
+
+    // Auto-play search: every reachable drop of the current piece, with its
+    // features and score, in search order. The features the evaluator reads
+    // are always filled in; `extraFeatures` asks for more, e.g. ALL_FEATURES
+    // when the candidates are recorded.
+    void evaluateMoves(std::vector<MoveCandidate>& out, uint32_t extraFeatures = 0) const;
+    // Drops the current piece straight down from x/rotation. Returns false if
+    // the piece does not fit there.
+    bool placeAt(int x, int rotation);
+    static BoardFeatures computeFeatures(const Rows& rows);
+    static double scoreFeatures(const BoardFeatures& features);
+
+    // Feature pass compiled for one FeatureBit mask: members outside it are
+    // left at zero and cost nothing. featureKernel picks the instance for a
+    // mask at run time, rounding it up to whole groups of features that share
+    // their work, so a few unrequested features may be filled in.
+    template <uint32_t Features>
+    static BoardFeatures computeFeatures(const Rows& rows);
+    using FeatureKernel = BoardFeatures (*)(const Rows& rows);
+    static FeatureKernel featureKernel(uint32_t features);
+
+    // Rule kernels on bare board data, for hosts that keep game state in their
+    // own layout (see SessionHost)
+    static bool collides(const Rows& rows, TetrominoType piece, int rotation, int x, int y);
+    static void lockPiece(Rows& rows, Board& board, TetrominoType piece, int rotation, int x, int y);
+    static int clearFullRows(Rows& rows, Board& board);  // Returns the number of rows cleared
+    static void searchMoves(const Rows& rows, TetrominoType piece, const Evaluator* evaluator,
+                            std::vector<MoveCandidate>& out, uint32_t extraFeatures = 0);
+
 private:
-    void initializeTetrominoes();
+    static bool collides(const Rows& rows, const PieceMask& piece, int x, int y);
+    static void stamp(Rows& rows, const PieceMask& piece, int x, int y);
+    static bool isConsistent(const State& state);
     int getGhostY() const;
     double evaluateBoard() const;
     std::pair<int, int> getBestMove() const;
     void autoPlayStep();
-};
\ No newline at end of file
+};
+
+#define BLOCKDROP_EXTERN_GAME(width, height) extern template class BasicBlockDropGame<width, height>;
+BLOCKDROP_GEOMETRIES(BLOCKDROP_EXTERN_GAME)
+#undef BLOCKDROP_EXTERN_GAME
+
+// The classic 10x20 game
+using BlockDropGame = BasicBlockDropGame<10, 20>;
@@ -0,0 +1,80 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+#include "Evaluator.h"
+
+// Evaluator read from a text file: a placement scores the sum of the terms the
+// file lists. Features no term reads are never computed, since the search asks
+// for getFeatureMask() only.
+//
+// Config file: one term per line, '#' starts a comment.
+//   <feature> <weight> [minus <threshold>] [if <condition> [and <condition>...]]
+// The term adds weight * (feature - threshold) when every condition holds. The
+// feature `constant` is always 1. A condition is "<feature> <op> <threshold>"
+// with op one of < <= > >=; a threshold is a number of rows or columns, or
+// top-N for N rows below the top of the board.
+// Features: max_height aggregate_height complete_lines holes bumpiness
+//           total_tiles nearly_complete_rows empty_columns
+class ConfigEvaluator : public Evaluator {
+private:
+    // Feature value range a term applies in, both ends inclusive
+    struct Condition {
+        int feature;
+        int min, max;
+    };
+
+    struct Term {
+        int feature;  // CONSTANT for the constant term
+        double weight;
+        int offset;
+        std::vector<Condition> conditions;
+    };
+
+    static const int CONSTANT = BlockDropGame::FEATURE_COUNT;
+
+    std::vector<Term> terms;  // Summed in file order
+    uint32_t featureMask;
+
+public:
+    ConfigEvaluator();
+
+    // `boardHeight` resolves top-N thresholds
+    bool load(const std::string& path, int boardHeight = BlockDropGame::BOARD_HEIGHT);
+
+    void scoreMoves(BlockDropGame::MoveCandidate* candidates, size_t count) const override;
+    uint32_t getFeatureMask() const override { return featureMask; }
+};
+
+// Serves the newest valid version of a config file. current() looks at the
+// file's modification time at most every CHECK_INTERVAL_MS and swaps a freshly
+// loaded evaluator in with an atomic store, so a retuned file is picked up
+// without a restart. Callers that fetch it once per game (--export, --ab) keep
+// that version to the end of the game; callers that fetch it every frame or
+// tick (single-game runs, --host) switch from the next piece. An invalid edit
+// keeps the previous version.
+class ConfigReloader {
+public:
+    static const int CHECK_INTERVAL_MS = 500;
+
+private:
+    std::string path;
+    int boardHeight;
+    std::shared_ptr<const ConfigEvaluator> evaluator;  // Accessed with std::atomic_load/store only
+    std::atomic<int64_t> nextCheck;       // steady_clock ticks; the thread that advances it checks the file
+    std::atomic<int64_t> loadedModified;  // Modification time of the file last loaded, in ns
+
+public:
+    ConfigReloader(const std::string& path, int boardHeight);
+
+    // Initial load; reports errors and returns false if the file is unusable
+    bool load();
+
+    // Thread-safe
+    std::shared_ptr<const Evaluator> current();
+
+private:
+    void reloadIfChanged();
+};
@@ -0,0 +1,19 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+#include "BlockDropGame.h"
+
+// Scores auto-play placements. BlockDropGame hands an evaluator every
+// candidate for the current piece at once, so implementations can batch.
+// One evaluator may be shared by games on several threads.
+class Evaluator {
+public:
+    virtual ~Evaluator() = default;
+
+    // Sets `score` on each candidate from its features; higher is better
+    virtual void scoreMoves(BlockDropGame::MoveCandidate* candidates, size_t count) const = 0;
+
+    // FeatureBit mask of the features scoreMoves reads. The search skips the
+    // others and leaves them at zero.
+    virtual uint32_t getFeatureMask() const { return BlockDropRules::ALL_FEATURES; }
+};
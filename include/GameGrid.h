@@ -0,0 +1,58 @@
+#pragma once
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "BlockDropGame.h"
+
+// Read-only view of one game, with the falling piece already merged into the cells
+struct BoardSnapshot {
+    uint8_t cells[BlockDropGame::BOARD_HEIGHT][BlockDropGame::BOARD_WIDTH];
+    int score;
+    int level;
+    int linesCleared;
+    bool gameOver;
+};
+
+// Runs many auto-play games on worker threads. Each game publishes a snapshot
+// after every tick; the renderer picks up the newest one without ever taking
+// a lock or blocking a worker.
+class GameGrid {
+private:
+    // Snapshots are double-buffered between the worker and the renderer, with a
+    // third slot handed back and forth through one atomic so that neither side
+    // can overwrite a buffer the other is still using.
+    struct Slot {
+        BlockDropGame game;
+        std::array<BoardSnapshot, 3> buffers;
+        std::atomic<int> shared;  // Index of the handoff buffer, plus FRESH_BIT
+        int writeIndex;           // Owned by the worker
+        int readIndex;            // Owned by the renderer
+    };
+
+    static const int FRESH_BIT = 4;
+
+    std::vector<std::unique_ptr<Slot>> slots;
+    std::vector<std::thread> workers;
+    std::atomic<bool> running;
+    double tickTime;
+
+public:
+    GameGrid(int gameCount, double tickTime = 1.0 / 60.0);
+    ~GameGrid();
+
+    void start(int threadCount);
+    void stop();
+
+    int size() const { return static_cast<int>(slots.size()); }
+
+    // Renderer side: newest published snapshot of game `index`. The reference
+    // stays valid until the next call for the same index.
+    const BoardSnapshot& acquireSnapshot(int index);
+
+private:
+    void workerLoop(int first, int last);
+    void publish(Slot& slot);
+};
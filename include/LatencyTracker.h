@@ -0,0 +1,74 @@
+#pragma once
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ostream>
+
+// Latency distribution in fixed log-spaced buckets, so recording never
+// allocates and memory stays constant however long a process runs.
+// Percentiles are accurate to one bucket, about 2%; the maximum is exact.
+class LatencyHistogram {
+public:
+    static constexpr double MIN_MS = 0.001;     // Everything below lands in bucket 0
+    static constexpr double GROWTH = 1.02;      // Upper bound ratio of neighbouring buckets
+    static const int BUCKET_COUNT = 1024;       // Up to about 10 minutes
+
+private:
+    std::array<uint64_t, BUCKET_COUNT> buckets;
+    uint64_t total;
+    double maximum;
+
+public:
+    LatencyHistogram();
+
+    void record(double milliseconds);
+    void merge(const LatencyHistogram& other);
+
+    uint64_t count() const { return total; }
+    double max() const { return maximum; }
+    double percentile(double p) const;  // p in [0, 1]; 0 when empty
+};
+
+// Measures input-to-display latency. Each key event opens a sample stamped
+// with the time the event was generated; the sample is then marked when
+// handleInput returns, when the game state visibly changes and when the next
+// frame has been presented.
+class LatencyTracker {
+public:
+    using Clock = std::chrono::steady_clock;
+
+    enum Stage {
+        DEQUEUED = 0,   // Event taken off the SDL queue
+        HANDLED,        // handleInput returned
+        STATE_CHANGED,  // Input changed the piece, board or score
+        PRESENTED,      // Frame showing the input was presented
+        STAGE_COUNT
+    };
+
+private:
+    struct PendingInput {
+        Clock::time_point eventTime;
+    };
+
+    static const int MAX_PENDING = 64;
+
+    // Inputs waiting for a presented frame. Beyond MAX_PENDING the newest are
+    // not kept; they are younger than every one that is.
+    PendingInput pending[MAX_PENDING];
+    int pendingCount;
+    Clock::time_point latestEventTime;  // Of the last input received, kept even when pending is full
+    LatencyHistogram samples[STAGE_COUNT];  // Milliseconds since the key event
+
+public:
+    LatencyTracker();
+
+    // eventAge is how long the event sat in the queue before being dequeued
+    void inputReceived(Clock::duration eventAge);
+    void inputHandled(bool stateChanged);
+    void framePresented();
+
+    void report(std::ostream& out) const;
+
+private:
+    void record(Stage stage, Clock::time_point eventTime, Clock::time_point now);
+};
@@ -0,0 +1,56 @@
+#pragma once
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "Evaluator.h"
+
+// Small quantized feed-forward network over the BoardFeatures of each
+// candidate. Activations are uint8 in [0, 127], weights int8, accumulation
+// int32, so the inner products map onto maddubs/madd and never saturate.
+// Hidden layers use a clipped ReLU; the last layer has one output, the score.
+//
+// Model file (little-endian):
+//   char magic[4] = "BDNN", uint32 version = 1
+//   uint32 inputCount (= FEATURE_COUNT), uint32 layerCount
+//   float inputScale[inputCount]      feature * scale, rounded, is the input activation
+//   per layer:
+//     uint32 outputs                  inputs are the previous layer's outputs
+//     float scale                     accumulator * scale is the next activation (or the score)
+//     int32 bias[outputs]
+//     int8 weights[outputs][inputs]
+class NeuralEvaluator : public Evaluator {
+public:
+    static const int MAX_LAYERS = 8;
+    static const int MAX_WIDTH = 1024;
+
+    // Inner product kernel for one layer over a batch of activation rows
+    using LayerKernel = void (*)(const uint8_t* inputs, size_t batch, int stride,
+                                 const int8_t* weights, const int32_t* bias, int outputs,
+                                 int32_t* accumulators);
+
+private:
+    struct Layer {
+        int inputs;
+        int outputs;
+        int stride;                   // inputs rounded up to the SIMD block
+        float scale;
+        std::vector<int32_t> bias;
+        std::vector<int8_t> weights;  // outputs rows of `stride` values, zero padded
+    };
+
+    std::array<float, BlockDropGame::FEATURE_COUNT> inputScale;
+    std::vector<Layer> layers;
+    LayerKernel kernel;
+    const char* kernelName;
+
+public:
+    NeuralEvaluator();
+
+    bool load(const std::string& path);
+
+    void scoreMoves(BlockDropGame::MoveCandidate* candidates, size_t count) const override;
+
+    // Instruction set the inner products run on: "avx2", "ssse3" or "scalar"
+    const char* getKernelName() const { return kernelName; }
+};
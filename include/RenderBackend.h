@@ -0,0 +1,54 @@
+#pragma once
+#include <cstdint>
+
+struct Color {
+    uint8_t r, g, b, a;
+};
+
+// Axis-aligned quad filled with one tile of the backend's palette atlas
+struct TileQuad {
+    int x, y, width, height;
+    int tile;
+};
+
+// Drawing primitives used by Renderer. Implementations own their output
+// surface (window, memory buffer, or nothing at all).
+class RenderBackend {
+public:
+    virtual ~RenderBackend() = default;
+
+    virtual bool initialize() = 0;
+    virtual void cleanup() = 0;
+
+    virtual void clear() = 0;
+    virtual void present() = 0;
+    // True once presented frames can no longer be delivered, e.g. because the
+    // frame output failed; the error has been reported already
+    virtual bool hasFailed() const { return false; }
+
+    virtual void setColor(const Color& color) = 0;
+    virtual void drawRect(int x, int y, int width, int height, bool filled) = 0;
+    virtual void drawText(const char* text, int x, int y) = 0;
+
+    // Palette entries become tiles of a single atlas; drawTiles submits a whole
+    // batch of tile quads as one piece of geometry.
+    virtual void setTilePalette(const Color* colors, int count) = 0;
+    virtual void drawTiles(const TileQuad* quads, int count) = 0;
+};
+
+// Backend that discards everything, for benchmarking the game loop alone
+class NullBackend : public RenderBackend {
+public:
+    bool initialize() override { return true; }
+    void cleanup() override {}
+
+    void clear() override {}
+    void present() override {}
+
+    void setColor(const Color&) override {}
+    void drawRect(int, int, int, int, bool) override {}
+    void drawText(const char*, int, int) override {}
+
+    void setTilePalette(const Color*, int) override {}
+    void drawTiles(const TileQuad*, int) override {}
+};
@@ -1,51 +1,85 @@
 #pragma once
-#include <SDL2/SDL.h>
-#include <SDL2/SDL_ttf.h>
-#include <string>
+#include <algorithm>
+#include <memory>
+#include <vector>
+#include "RenderBackend.h"
 
-class BlockDropGame;
+template <int Width, int Height> class BasicBlockDropGame;
+class GameGrid;
 
 class Renderer {
-private:
-    SDL_Window* window;
-    SDL_Renderer* renderer;
-    TTF_Font* font;
-    
+public:
     static const int WINDOW_WIDTH = 800;
     static const int WINDOW_HEIGHT = 600;
+
+private:
+    std::unique_ptr<RenderBackend> backend;
+
     static const int CELL_SIZE = 25;
     static const int BOARD_OFFSET_X = 50;
     static const int BOARD_OFFSET_Y = 50;
-    
+    static const int HUD_GAP = 20;     // Between the board and the HUD column
+    static const int HUD_WIDTH = 260;  // Widest HUD line in the software font
+
     // Colors for different tetrominoes (index 0 = empty, 1-7 = I,O,T,S,Z,J,L)
-    SDL_Color colors[8] = {
+    Color colors[8] = {
         {0, 0, 0, 255},       // 0: Empty
         {0, 255, 255, 255},   // 1: I piece - Cyan
-        {255, 255, 0, 255},   // 2: O piece - Yellow  
+        {255, 255, 0, 255},   // 2: O piece - Yellow
         {128, 0, 128, 255},   // 3: T piece - Purple
         {0, 255, 0, 255},     // 4: S piece - Green
         {255, 0, 0, 255},     // 5: Z piece - Red
         {0, 0, 255, 255},     // 6: J piece - Blue
         {255, 165, 0, 255}    // 7: L piece - Orange
     };
-    
+
+    // Atlas tiles after the eight cell colors, used by the grid view
+    enum GridTile {
+        TILE_BOARD_BACKGROUND = 8,
+        TILE_BOARD_BORDER,
+        TILE_GAME_OVER_BORDER,
+        TILE_COUNT
+    };
+
+    static const int GRID_HEADER_HEIGHT = 24;
+    static const int GRID_GAP = 4;
+
+    std::vector<TileQuad> gridQuads;  // Reused every frame
+
 public:
-    Renderer();
-    ~Renderer();
-    
+    Renderer();  // SDL window backend
+    explicit Renderer(std::unique_ptr<RenderBackend> backend);
+
     bool initialize();
     void cleanup();
-    
+
     void clear();
     void present();
-    
-    void drawGame(const BlockDropGame& game);
-    
+
+    // Instantiated for every board geometry in BLOCKDROP_GEOMETRIES
+    template <int Width, int Height>
+    void drawGame(const BasicBlockDropGame<Width, Height>& game);
+    void drawGrid(GameGrid& grid);
+
+    RenderBackend& getBackend() { return *backend; }
+
 private:
-    void drawBoard(const BlockDropGame& game);
-    void drawCurrentPiece(const BlockDropGame& game);
-    void drawUI(const BlockDropGame& game);
-    void drawText(const std::string& text, int x, int y);
-    void setColor(const SDL_Color& color);
+    // Largest cell size, up to CELL_SIZE, that fits the board and the HUD
+    // column to its right into the window
+    template <int Width, int Height>
+    static constexpr int cellSize() {
+        return std::min({CELL_SIZE,
+                         (WINDOW_WIDTH - BOARD_OFFSET_X - HUD_GAP - HUD_WIDTH) / Width,
+                         (WINDOW_HEIGHT - 2 * BOARD_OFFSET_Y) / Height});
+    }
+
+    template <int Width, int Height>
+    void drawBoard(const BasicBlockDropGame<Width, Height>& game);
+    template <int Width, int Height>
+    void drawCurrentPiece(const BasicBlockDropGame<Width, Height>& game);
+    template <int Width, int Height>
+    void drawUI(const BasicBlockDropGame<Width, Height>& game);
+    void drawText(const char* text, int x, int y);
+    void setColor(const Color& color);
     void drawRect(int x, int y, int width, int height, bool filled = true);
-};
\ No newline at end of file
+};
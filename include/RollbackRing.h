@@ -0,0 +1,28 @@
+#pragma once
+#include <cstddef>
+#include <vector>
+#include "BlockDropGame.h"
+
+// Fixed-depth history of game snapshots for undo and what-if search. Storage
+// is allocated once; pushing past the depth overwrites the oldest snapshot.
+class RollbackRing {
+private:
+    std::vector<BlockDropGame::State> states;
+    size_t head;   // Slot the next push writes to
+    size_t count;
+
+public:
+    explicit RollbackRing(size_t depth);
+
+    void push(const BlockDropGame& game);
+
+    // Restores the most recent snapshot into `game` and drops it
+    bool undo(BlockDropGame& game);
+
+    // Snapshot `stepsBack` pushes ago (0 = most recent), or nullptr
+    const BlockDropGame::State* peek(size_t stepsBack = 0) const;
+
+    void clear() { head = 0; count = 0; }
+    size_t size() const { return count; }
+    size_t depth() const { return states.size(); }
+};
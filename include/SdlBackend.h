@@ -0,0 +1,38 @@
+#pragma once
+#include <SDL2/SDL.h>
+#include <SDL2/SDL_ttf.h>
+#include <vector>
+#include "RenderBackend.h"
+
+class SdlBackend : public RenderBackend {
+private:
+    SDL_Window* window;
+    SDL_Renderer* renderer;
+    TTF_Font* font;
+    SDL_Texture* atlas;
+    int atlasTiles;
+
+    // Reused between frames so a tile batch does not allocate once warmed up
+    std::vector<SDL_Vertex> vertices;
+    std::vector<int> indices;
+
+    int width;
+    int height;
+
+public:
+    SdlBackend(int width, int height);
+    ~SdlBackend() override;
+
+    bool initialize() override;
+    void cleanup() override;
+
+    void clear() override;
+    void present() override;
+
+    void setColor(const Color& color) override;
+    void drawRect(int x, int y, int width, int height, bool filled) override;
+    void drawText(const char* text, int x, int y) override;
+
+    void setTilePalette(const Color* colors, int count) override;
+    void drawTiles(const TileQuad* quads, int count) override;
+};
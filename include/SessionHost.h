@@ -0,0 +1,175 @@
+#pragma once
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <thread>
+#include <vector>
+#include "BlockDropGame.h"
+#include "LatencyTracker.h"
+
+// Names one hosted session. The generation changes whenever the index is
+// reused, so a stale handle can never reach the session that replaced it.
+struct SessionHandle {
+    uint32_t index;
+    uint32_t generation;
+};
+
+// Copy of one session, as a renderer or server would send it out
+struct SessionView {
+    BlockDropGame::Board board;  // Without the falling piece
+    BlockDropGame::TetrominoType piece;
+    int x, y, rotation;
+    int score, level, linesCleared;
+    bool bot;
+    bool gameOver;
+};
+
+// Hosts many independent player and bot sessions of the classic game in one
+// process. Session state lives in structure-of-arrays arenas split into
+// shards: each field of every session in a shard sits in its own contiguous
+// array, so a tick streams through timers and piece state without touching
+// the boards of sessions that are not due to move. Shards are advanced in
+// parallel, each by exactly one worker, and receive inputs through their own
+// lock-free queue.
+//
+// Arenas are sized once at construction. A destroyed session is replaced by
+// the last one of its shard, so the arrays stay dense and never reallocate.
+class SessionHost {
+public:
+    using Game = BlockDropGame;
+    using Clock = std::chrono::steady_clock;
+
+    // Falling speed of bots, which teleport to their chosen column at spawn
+    static constexpr float BOT_FALL_INTERVAL = 0.02f;
+    static const uint32_t INPUT_QUEUE_SIZE = 4096;  // Per shard, power of two
+
+private:
+    struct Input {
+        SessionHandle handle;
+        char key;
+        Clock::time_point time;
+    };
+
+    // Bounded multi-producer, single-consumer ring. Every cell carries a
+    // sequence number telling producers and the consumer whose turn it is, so
+    // producers only contend on the tail counter and never block each other.
+    class InputQueue {
+    private:
+        struct Cell {
+            std::atomic<uint32_t> sequence;
+            Input input;
+        };
+
+        std::unique_ptr<Cell[]> cells;
+        uint32_t mask;
+        alignas(64) std::atomic<uint32_t> tail;  // Next cell to claim, shared by producers
+        alignas(64) uint32_t head;               // Next cell to read, owned by the consumer
+
+    public:
+        explicit InputQueue(uint32_t size);
+
+        bool push(const Input& input);  // False when full
+        bool pop(Input& out);
+    };
+
+    enum Flags : uint8_t {
+        BOT = 1,
+        FINISHED = 2
+    };
+
+    // Slot i of every array is the same session
+    struct Shard {
+        std::vector<float> fallTime;
+        std::vector<float> fallInterval;  // Seconds per row, infinite once the game is over
+        std::vector<Game::Rows> rows;
+        std::vector<uint8_t> piece;
+        std::vector<uint8_t> rotation;
+        std::vector<int8_t> x;
+        std::vector<int8_t> y;
+        std::vector<uint64_t> rng;        // xorshift64* state
+        std::vector<int32_t> score;
+        std::vector<int32_t> lines;
+        std::vector<int32_t> level;
+        std::vector<uint8_t> flags;
+        std::vector<uint32_t> owner;      // Session index of each slot
+        std::vector<Game::Board> cells;   // Only written when a piece locks
+
+        std::vector<uint32_t> due;        // Tick scratch: slots that fall a row this tick
+        std::vector<Game::MoveCandidate> candidates;
+        std::vector<SessionHandle> finished;  // Games that ended since takeFinished
+        LatencyHistogram inputLatency;    // Milliseconds from submitInput to applied
+        uint64_t piecesPlaced;
+        InputQueue inputs;
+
+        explicit Shard(size_t capacity);
+    };
+
+    static const uint32_t NO_SLOT = UINT32_MAX;
+
+    std::vector<std::unique_ptr<Shard>> shards;
+    std::vector<uint32_t> generations;  // Per session index
+    std::vector<uint32_t> slotOf;       // Per session index, NO_SLOT when free
+    std::vector<uint32_t> freeIndices;  // Stack; popped in order so sessions spread over shards
+    LatencyHistogram tickTimes;         // Milliseconds per tick of the whole fleet
+    std::shared_ptr<const Evaluator> evaluator;  // Bot move scoring, nullptr = built-in heuristic
+
+    // Worker pool. tick() bumps tickNumber; each worker advances its shards
+    // and the last one to finish wakes tick() up again.
+    std::vector<std::thread> workers;
+    std::mutex mutex;
+    std::condition_variable tickStarted;
+    std::condition_variable tickFinished;
+    uint64_t tickNumber;
+    int workersBusy;
+    float tickDelta;
+    bool running;
+
+public:
+    SessionHost(uint32_t capacity, int shardCount);
+    ~SessionHost();
+    SessionHost(const SessionHost&) = delete;
+    SessionHost& operator=(const SessionHost&) = delete;
+
+    void start(int threadCount);
+    void stop();
+
+    // create, destroy, getSession, takeFinished and setEvaluator must not
+    // overlap a tick. create returns false when the host is full.
+    bool create(uint64_t seed, bool bot, SessionHandle& out);
+    bool destroy(SessionHandle handle);
+    bool getSession(SessionHandle handle, SessionView& out) const;
+    // Appends the handles of games that ended since the last call
+    void takeFinished(std::vector<SessionHandle>& out);
+    // Scores the moves of every bot from its next piece on; also between ticks only
+    void setEvaluator(std::shared_ptr<const Evaluator> evaluator) { this->evaluator = std::move(evaluator); }
+
+    // Queues a key ('a', 'd', 's', 'w' or ' ') for the next tick. Thread-safe,
+    // may be called while a tick runs. Returns false if the shard's queue is full.
+    bool submitInput(SessionHandle handle, char key);
+
+    // Advances every session by deltaTime seconds, on the workers if started
+    void tick(double deltaTime);
+
+    uint32_t size() const { return static_cast<uint32_t>(slotOf.size() - freeIndices.size()); }
+    uint32_t capacity() const { return static_cast<uint32_t>(slotOf.size()); }
+    uint64_t getPiecesPlaced() const;
+
+    // Tick time and input latency percentiles
+    void report(std::ostream& out) const;
+
+private:
+    bool isLive(SessionHandle handle) const;
+    Shard& shardOf(uint32_t index) { return *shards[index % shards.size()]; }
+    const Shard& shardOf(uint32_t index) const { return *shards[index % shards.size()]; }
+
+    void workerLoop(int worker, int workerCount);
+    void tickShard(Shard& shard, float deltaTime);
+    void applyInput(Shard& shard, uint32_t slot, char key);
+    void stepDown(Shard& shard, uint32_t slot);
+    void lockAndSpawn(Shard& shard, uint32_t slot);
+    void spawn(Shard& shard, uint32_t slot);
+};
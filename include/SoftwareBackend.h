@@ -0,0 +1,68 @@
+#pragma once
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <vector>
+#include "RenderBackend.h"
+
+// CPU rasterizer drawing into an in-memory RGBA buffer. Each presented
+// frame can optionally be streamed out as raw RGBA video or as PNG images.
+//
+// Output path conventions:
+//   "-"            write to stdout
+//   "|command"     pipe frames into a shell command (e.g. ffmpeg)
+//   "frame%05d.png" one file per frame (PNG only, exactly one %d, %% for a literal %)
+//   anything else  append every frame to a single file
+class SoftwareBackend : public RenderBackend {
+public:
+    enum class OutputFormat {
+        None, RawVideo, PngSequence
+    };
+
+private:
+    int width;
+    int height;
+    std::vector<uint32_t> pixels;  // width * height, RGBA byte order
+    uint32_t currentPixel;  // Current color packed in buffer byte order
+    std::vector<uint32_t> palette;  // Tile colors packed the same way
+
+    OutputFormat format;
+    std::string outputPath;
+    FILE* output;
+    bool outputIsPipe;
+    bool outputPerFrame;
+    bool outputFailed;               // Set by the first failed write; later frames are dropped
+    std::vector<uint8_t> pngBuffer;  // Encoded frame, sized once in initialize()
+    std::vector<char> pathBuffer;    // Formatted per-frame file name
+    uint64_t frameCount;
+
+public:
+    SoftwareBackend(int width, int height,
+                    OutputFormat format = OutputFormat::None,
+                    const std::string& outputPath = "");
+    ~SoftwareBackend() override;
+
+    bool initialize() override;
+    void cleanup() override;
+
+    void clear() override;
+    void present() override;
+    bool hasFailed() const override { return outputFailed; }
+
+    void setColor(const Color& color) override;
+    void drawRect(int x, int y, int width, int height, bool filled) override;
+    void drawText(const char* text, int x, int y) override;
+
+    void setTilePalette(const Color* colors, int count) override;
+    void drawTiles(const TileQuad* quads, int count) override;
+
+    const uint8_t* getPixels() const { return reinterpret_cast<const uint8_t*>(pixels.data()); }
+    int getWidth() const { return width; }
+    int getHeight() const { return height; }
+    uint64_t getFrameCount() const { return frameCount; }
+
+private:
+    void fillClipped(int x, int y, int w, int h);
+    size_t encodePng();
+    bool writeFrame(const uint8_t* data, size_t size);
+};
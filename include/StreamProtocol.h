@@ -0,0 +1,65 @@
+#pragma once
+#include <cstddef>
+#include <cstdint>
+
+// Wire format of the spectator stream.
+//
+// Every message starts with a 3 byte header: total length (uint16, little
+// endian, header included) and a MessageType. A subscriber first receives a
+// keyframe holding the complete state, then one delta per simulation tick.
+// Keyframes are repeated periodically after that tick's delta and carry a hash
+// of the full state so clients can verify their reconstruction.
+namespace stream {
+
+const int MAX_BOARD_WIDTH = 32;
+const int MAX_BOARD_HEIGHT = 64;
+const size_t HEADER_SIZE = 3;
+const size_t MAX_MESSAGE_SIZE = 1024;
+
+enum class MessageType : uint8_t {
+    Keyframe = 1,
+    Delta = 2
+};
+
+// Delta field flags: only groups that changed since the previous tick are sent
+enum DeltaField : uint8_t {
+    FIELD_ROWS = 1,    // uint64 changed-row mask, then each changed row
+    FIELD_PIECE = 2,   // type, rotation, x, y
+    FIELD_STATS = 4,   // score, level, lines
+    FIELD_STATUS = 8   // game over flag
+};
+
+// Everything a spectator can see. Cells hold 0 for empty, 1-7 for piece colors.
+struct GameState {
+    uint32_t tick;
+    uint8_t width;
+    uint8_t height;
+    uint8_t cells[MAX_BOARD_HEIGHT][MAX_BOARD_WIDTH];
+    uint8_t pieceType;
+    uint8_t rotation;
+    int8_t x;
+    int8_t y;
+    uint32_t score;
+    uint16_t level;
+    uint32_t linesCleared;
+    uint8_t gameOver;
+};
+
+// Rows are packed 3 bits per cell
+inline size_t rowBytes(int width) {
+    return (static_cast<size_t>(width) * 3 + 7) / 8;
+}
+
+// FNV-1a over the visible board, piece and counters
+uint64_t stateHash(const GameState& state);
+
+// Encoders write into `out` (at least MAX_MESSAGE_SIZE bytes) and return the message size
+size_t encodeKeyframe(const GameState& state, uint8_t* out);
+size_t encodeDelta(const GameState& previous, const GameState& current, uint8_t* out);
+
+// Applies one complete message to `state`. Returns false on malformed input.
+// For keyframes, `keyframeHash` receives the hash the sender computed.
+bool decodeMessage(const uint8_t* data, size_t size, GameState& state,
+                   MessageType& type, uint64_t& keyframeHash);
+
+} // namespace stream
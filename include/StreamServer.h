@@ -0,0 +1,85 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include "StreamProtocol.h"
+
+template <int Width, int Height> class BasicBlockDropGame;
+
+// Single-producer, multi-consumer broadcast ring of stream messages. The
+// producer never waits: it overwrites the oldest slot, and a reader that has
+// been lapped detects it through the slot sequence number.
+class BroadcastRing {
+public:
+    static const size_t CAPACITY = 1024;  // Messages, a power of two
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> sequence;  // 2 * index + 1 while writing, 2 * index + 2 when done
+        uint16_t size;
+        uint8_t data[stream::MAX_MESSAGE_SIZE];
+    };
+
+    std::unique_ptr<Slot[]> slots;
+    std::atomic<uint64_t> head;  // Index of the next message to be written
+
+public:
+    BroadcastRing();
+
+    void push(const uint8_t* data, size_t size);
+    uint64_t getHead() const { return head.load(std::memory_order_acquire); }
+
+    // Copies message `index` into `out`. Returns 0 if it was already overwritten.
+    size_t read(uint64_t index, uint8_t* out) const;
+};
+
+// Publishes BlockDropGame state to spectators on a Unix domain socket. The
+// game loop calls publish() once per tick; socket I/O happens on a separate
+// thread, and subscribers that fall a full ring behind are disconnected.
+class StreamServer {
+private:
+    struct Subscriber {
+        int fd;
+        uint64_t cursor;               // Next ring index to send
+        std::vector<uint8_t> pending;  // Encoded bytes not yet accepted by the socket
+        size_t pendingOffset;
+    };
+
+    std::string socketPath;
+    int keyframeInterval;
+    int listenFd;
+
+    BroadcastRing ring;
+    std::atomic<uint64_t> lastKeyframe;  // Ring index where new subscribers start
+
+    stream::GameState previousState;
+    stream::GameState currentState;
+    uint8_t messageBuffer[stream::MAX_MESSAGE_SIZE];
+    uint32_t tick;
+
+    std::vector<Subscriber> subscribers;  // Owned by the I/O thread
+    std::thread ioThread;
+    std::atomic<bool> running;
+
+public:
+    explicit StreamServer(const std::string& socketPath, int keyframeInterval = 60);
+    ~StreamServer();
+
+    bool start();
+    void stop();
+
+    // Call from the simulation thread after each update. Instantiated for
+    // every board geometry in BLOCKDROP_GEOMETRIES.
+    template <int Width, int Height>
+    void publish(const BasicBlockDropGame<Width, Height>& game);
+
+private:
+    template <int Width, int Height>
+    void capture(const BasicBlockDropGame<Width, Height>& game, stream::GameState& state) const;
+    void ioLoop();
+    void acceptSubscribers();
+    bool serviceSubscriber(Subscriber& subscriber);
+};
@@ -0,0 +1,201 @@
+#pragma once
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "BlockDropGame.h"
+
+// Self-play training data: one record per auto-play decision, stored in a
+// chunked columnar file. Each chunk holds whole games, so the game outcome is
+// known before the chunk is compressed and written.
+//
+// File layout (little-endian):
+//   FileHeader
+//   repeated: ChunkHeader, ColumnEntry[columnCount], column payloads
+namespace training {
+
+const uint32_t FORMAT_VERSION = 3;
+
+// Per-record columns have one value per decision; per-candidate columns have
+// one value per evaluated placement, `candidate_count` of them per record.
+enum Column : uint16_t {
+    GAME_ID,              // u64
+    MOVE_INDEX,           // u32, decision number within the game
+    BOARD,                // u32 x boardHeight, occupancy mask of each row, top row first
+    PIECE,                // u8, TetrominoType
+    CANDIDATE_COUNT,      // u16
+    CHOSEN,               // u16, index of the played candidate
+    FINAL_SCORE,          // i32, score when the game ended
+    FINAL_LINES,          // i32
+    MOVES_REMAINING,      // u32, decisions left in the game after this one
+    TRUNCATED,            // u8, 1 if the game was cut off at the self-play move
+                          // limit; the outcome columns then describe the cut-off point
+    CANDIDATE_X,          // i8
+    CANDIDATE_ROTATION,   // u8
+    FEATURE_FIRST,        // i16 x FEATURE_COUNT, in BoardFeatures member order
+    CANDIDATE_SCORE = FEATURE_FIRST + BlockDropRules::FEATURE_COUNT,  // f32, from the FileHeader scorer
+    COLUMN_COUNT
+};
+
+enum class Codec : uint8_t {
+    Raw,
+    Zlib
+};
+
+// What filled CANDIDATE_SCORE
+enum class Scorer : uint8_t {
+    Heuristic,  // Built-in evaluateBoard heuristic
+    Model,      // --model network
+    Config      // --eval-config terms, possibly reloaded between games
+};
+
+const size_t SCORER_NAME_SIZE = 60;
+
+struct FileHeader {
+    char magic[4];            // "BDTR"
+    uint32_t version;
+    uint16_t boardWidth;
+    uint16_t boardHeight;
+    uint16_t featureCount;
+    uint16_t columnCount;
+    uint8_t scorer;           // Scorer
+    uint8_t reserved[3];
+    char scorerName[SCORER_NAME_SIZE];  // Model or config path, zero-padded and cut to fit
+};
+
+struct ChunkHeader {
+    char magic[4];            // "CHNK"
+    uint32_t recordCount;
+    uint32_t candidateCount;
+    uint32_t columnCount;
+    uint64_t payloadSize;     // Bytes of column data after the directory
+    // Summary fields, readable without decoding. Workers share one game id
+    // counter, so a chunk's games lie between the bounds but are not a range.
+    uint64_t minGameId;
+    uint64_t maxGameId;
+    int32_t bestFinalScore;
+    uint32_t gameCount;
+};
+
+struct ColumnEntry {
+    uint16_t column;
+    uint8_t codec;
+    uint8_t reserved;
+    uint32_t valueSize;       // Bytes per value
+    uint64_t rawSize;
+    uint64_t storedSize;
+    uint64_t offset;          // From the start of the chunk's payload
+};
+
+static_assert(sizeof(FileHeader) == 80, "FileHeader layout is part of the format");
+static_assert(sizeof(ChunkHeader) == 48, "ChunkHeader layout is part of the format");
+static_assert(sizeof(ColumnEntry) == 32, "ColumnEntry layout is part of the format");
+
+// Shared output file. Chunks arrive fully encoded, so the lock only covers
+// the write itself.
+class TrainingWriter {
+private:
+    FILE* file;
+    int boardWidth, boardHeight;
+    std::mutex mutex;
+    std::atomic<uint64_t> bytesWritten;
+    std::atomic<uint64_t> recordsWritten;
+    bool failed;
+
+public:
+    TrainingWriter();
+    ~TrainingWriter();
+
+    bool open(const std::string& path, int boardWidth = BlockDropGame::BOARD_WIDTH,
+              int boardHeight = BlockDropGame::BOARD_HEIGHT, Scorer scorer = Scorer::Heuristic,
+              const std::string& scorerName = std::string());
+    bool close();
+
+    // Appends one encoded chunk. Thread-safe.
+    bool writeChunk(const std::vector<uint8_t>& chunk, uint32_t records);
+
+    uint64_t getBytesWritten() const { return bytesWritten.load(std::memory_order_relaxed); }
+    uint64_t getRecordsWritten() const { return recordsWritten.load(std::memory_order_relaxed); }
+    int getBoardWidth() const { return boardWidth; }
+    int getBoardHeight() const { return boardHeight; }
+};
+
+// Per-thread record buffer. Columns are appended in memory, then compressed
+// on the calling thread and handed to the writer once enough games finish.
+class ChunkBuilder {
+private:
+    TrainingWriter& writer;
+    size_t chunkRecords;  // Flush threshold, checked at game boundaries
+
+    std::vector<uint8_t> columns[COLUMN_COUNT];
+    uint32_t recordCount;
+    uint32_t candidateCount;
+    size_t gameStart;     // First record of the game in progress
+    uint64_t gameId;
+    uint32_t moveIndex;
+    uint64_t minGameId, maxGameId;  // Of the finished games in the chunk
+    uint32_t gameCount;
+    int32_t bestFinalScore;
+
+    std::vector<uint8_t> chunk;  // Encoded output, reused between flushes
+    std::vector<uint8_t> scratch;
+
+public:
+    ChunkBuilder(TrainingWriter& writer, size_t chunkRecords = 16384);
+
+    void beginGame(uint64_t id);
+    // `candidates` as returned by evaluateMoves for the game's current piece.
+    // The game must have the geometry the writer was opened with.
+    template <int Width, int Height>
+    void recordDecision(const BasicBlockDropGame<Width, Height>& game,
+                        const std::vector<BlockDropRules::MoveCandidate>& candidates,
+                        size_t chosen);
+    template <int Width, int Height>
+    void endGame(const BasicBlockDropGame<Width, Height>& game) {
+        finishGame(game.getScore(), game.getLinesCleared(), !game.isGameOver());
+    }
+
+    // Writes out whatever finished games are buffered
+    bool flush();
+
+private:
+    template <typename T>
+    void append(Column column, T value);
+    void finishGame(int32_t finalScore, int32_t finalLines, bool truncated);
+    void reset();
+};
+
+struct ChunkView {
+    ChunkHeader header;
+    std::vector<ColumnEntry> columns;
+    const uint8_t* payload;
+};
+
+// Memory-mapped reader. open() walks the chunk headers and directories only;
+// column data is decompressed on request.
+class TrainingReader {
+private:
+    const uint8_t* data;
+    size_t size;
+    FileHeader header;
+    std::vector<ChunkView> chunks;
+
+public:
+    TrainingReader();
+    ~TrainingReader();
+    TrainingReader(const TrainingReader&) = delete;
+    TrainingReader& operator=(const TrainingReader&) = delete;
+
+    bool open(const std::string& path);
+    void close();
+
+    const FileHeader& getHeader() const { return header; }
+    const std::vector<ChunkView>& getChunks() const { return chunks; }
+
+    // Decodes one column of a chunk into `out` (rawSize bytes)
+    bool decodeColumn(const ChunkView& chunk, Column column, std::vector<uint8_t>& out) const;
+};
+
+} // namespace training
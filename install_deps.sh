@@ -11,7 +11,7 @@ if [ "$EUID" -ne 0 ]; then
 fi
 
 apt update
-apt install -y build-essential cmake libsdl2-dev libsdl2-ttf-dev pkg-config
+apt install -y build-essential cmake libsdl2-dev libsdl2-ttf-dev zlib1g-dev pkg-config
 
 echo "Dependencies installed successfully!"
 echo "You can now build the project with:"
@@ -1,21 +1,94 @@
 #include "BlockDropGame.h"
+#include "Evaluator.h"
 #include <algorithm>
 #include <chrono>
+#include <cstring>
+#include <fstream>
+#include <utility>
 
-BlockDropGame::BlockDropGame() 
-    : board(BOARD_HEIGHT, std::vector<int>(BOARD_WIDTH, 0))
-    , currentPiece(TetrominoType::I)
-    , currentX(0), currentY(0), currentRotation(0)
-    , score(0), level(1), linesCleared(0), gameOver(false)
-    , fallTime(0.0), fallSpeed(0.5), autoPlay(false), autoPlayPositioned(false)
-    , targetX(0), targetRotation(0), autoTimer(0.0)
-    , rng(std::chrono::steady_clock::now().time_since_epoch().count())
+namespace {
+
+// Checkpoints are the raw State bytes behind a small header, so they load only
+// into a build with the same State layout and board geometry.
+const uint32_t CHECKPOINT_VERSION = 2;
+
+struct CheckpointHeader {
+    char magic[4];
+    uint32_t version;
+    uint32_t stateSize;
+    uint16_t boardWidth;
+    uint16_t boardHeight;
+};
+
+int popcount(uint32_t bits) {
+    return __builtin_popcount(bits);
+}
+
+// Features that come out of the same per-row work. Kernels are only compiled
+// for whole groups; computing the rest of a group costs next to nothing.
+constexpr uint32_t FEATURE_GROUPS[] = {
+    BlockDropRules::FEATURE_MAX_HEIGHT | BlockDropRules::FEATURE_AGGREGATE_HEIGHT |
+        BlockDropRules::FEATURE_BUMPINESS,
+    BlockDropRules::FEATURE_TOTAL_TILES | BlockDropRules::FEATURE_NEARLY_COMPLETE_ROWS,
+    BlockDropRules::FEATURE_COMPLETE_LINES,
+    BlockDropRules::FEATURE_HOLES,
+    BlockDropRules::FEATURE_EMPTY_COLUMNS
+};
+
+constexpr uint32_t wholeGroups(uint32_t features) {
+    uint32_t result = 0;
+    for (uint32_t group : FEATURE_GROUPS) {
+        if (features & group) result |= group;
+    }
+    return result;
+}
+
+// Feature kernel for every FeatureBit mask, indexed by the mask
+template <typename Game, size_t... Masks>
+std::array<typename Game::FeatureKernel, sizeof...(Masks)> featureKernelTable(std::index_sequence<Masks...>) {
+    return {{&Game::template computeFeatures<wholeGroups(static_cast<uint32_t>(Masks))>...}};
+}
+
+} // namespace
+
+const std::array<BlockDropRules::Tetromino, BlockDropRules::PIECE_COUNT>
+    BlockDropRules::tetrominoes = BlockDropRules::createTetrominoes();
+
+const std::array<std::array<BlockDropRules::PieceMask, BlockDropRules::MAX_ROTATIONS>, BlockDropRules::PIECE_COUNT>
+    BlockDropRules::pieceMasks = BlockDropRules::createPieceMasks();
+
+template <int Width, int Height>
+BasicBlockDropGame<Width, Height>::BasicBlockDropGame()
+    : BasicBlockDropGame(std::chrono::steady_clock::now().time_since_epoch().count())
 {
-    initializeTetrominoes();
+}
+
+template <int Width, int Height>
+BasicBlockDropGame<Width, Height>::BasicBlockDropGame(uint64_t seed) {
+    std::memset(&state, 0, sizeof(State));  // Padding too, so checkpoints are deterministic
+    state.rngState = seed ? seed : 0x9E3779B97F4A7C15ull;  // xorshift must not start at zero
+    state.fallTime = 0.0;
+    state.fallSpeed = 0.5;
+    state.autoTimer = 0.0;
+    state.currentPiece = TetrominoType::I;
+    state.currentX = 0;
+    state.currentY = 0;
+    state.currentRotation = 0;
+    state.score = 0;
+    state.level = 1;
+    state.linesCleared = 0;
+    state.targetX = 0;
+    state.targetRotation = 0;
+    state.gameOver = false;
+    state.autoPlay = false;
+    state.autoPlayPositioned = false;
+    
     newPiece();
 }
 
-void BlockDropGame::initializeTetrominoes() {
+std::array<BlockDropRules::Tetromino, BlockDropRules::PIECE_COUNT> BlockDropRules::createTetrominoes() {
+    std::array<Tetromino, PIECE_COUNT> tetrominoes;
+    
     // I piece
     tetrominoes[0].rotations = {
         {".....", "..#..", "..#..", "..#..", "..#.."},
@@ -62,121 +135,264 @@ void BlockDropGame::initializeTetrominoes() {
         {".....", "##...", ".#...", ".#...", "....."},
         {".....", ".....", "..#..", "###..", "....."}
     };
+    
+    return tetrominoes;
+}
+
+std::array<std::array<BlockDropRules::PieceMask, BlockDropRules::MAX_ROTATIONS>, BlockDropRules::PIECE_COUNT>
+BlockDropRules::createPieceMasks() {
+    std::array<std::array<PieceMask, MAX_ROTATIONS>, PIECE_COUNT> masks = {};
+    for (int piece = 0; piece < PIECE_COUNT; piece++) {
+        const auto& rotations = tetrominoes[piece].rotations;
+        for (size_t rotation = 0; rotation < rotations.size(); rotation++) {
+            for (int y = 0; y < PIECE_SIZE; y++) {
+                for (int x = 0; x < PIECE_SIZE; x++) {
+                    if (rotations[rotation][y][x] == '#') {
+                        masks[piece][rotation].rows[y] |= 1 << x;
+                    }
+                }
+            }
+        }
+    }
+    return masks;
+}
+
+uint32_t BlockDropRules::nextRandom(uint64_t& rngState) {
+    rngState ^= rngState >> 12;
+    rngState ^= rngState << 25;
+    rngState ^= rngState >> 27;
+    return static_cast<uint32_t>((rngState * 0x2545F4914F6CDD1Dull) >> 32);
+}
+
+BlockDropRules::TetrominoType BlockDropRules::randomPiece(uint64_t& rngState) {
+    uint64_t pieceCount = static_cast<uint64_t>(TetrominoType::COUNT);
+    return static_cast<TetrominoType>((nextRandom(rngState) * pieceCount) >> 32);
+}
+
+double BlockDropRules::fallSpeedForLevel(int level) {
+    return std::max(0.1, 0.5 - (level - 1) * 0.05);
+}
+
+template <int Width, int Height>
+void BasicBlockDropGame<Width, Height>::saveState(State& out) const {
+    std::memcpy(&out, &state, sizeof(State));
+}
+
+template <int Width, int Height>
+void BasicBlockDropGame<Width, Height>::restoreState(const State& in) {
+    std::memcpy(&state, &in, sizeof(State));
 }
 
-void BlockDropGame::newPiece() {
-    std::uniform_int_distribution<int> dist(0, static_cast<int>(TetrominoType::COUNT) - 1);
-    currentPiece = static_cast<TetrominoType>(dist(rng));
-    currentRotation = 0;
-    currentX = BOARD_WIDTH / 2 - 2;
-    currentY = 0;
-    autoPlayPositioned = false;  // Reset positioning state for new piece
-    autoTimer = 0.0;  // Reset auto-play timer
+template <int Width, int Height>
+bool BasicBlockDropGame<Width, Height>::saveCheckpoint(const std::string& path) const {
+    CheckpointHeader header = {
+        {'B', 'D', 'C', 'K'}, CHECKPOINT_VERSION,
+        static_cast<uint32_t>(sizeof(State)), BOARD_WIDTH, BOARD_HEIGHT
+    };
+    
+    std::ofstream file(path, std::ios::binary);
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    file.write(reinterpret_cast<const char*>(&state), sizeof(State));
+    return static_cast<bool>(file);
+}
+
+template <int Width, int Height>
+bool BasicBlockDropGame<Width, Height>::loadCheckpoint(const std::string& path) {
+    std::ifstream file(path, std::ios::binary);
+    CheckpointHeader header;
+    State loaded;
+    if (!file.read(reinterpret_cast<char*>(&header), sizeof(header)) ||
+        std::memcmp(header.magic, "BDCK", 4) != 0 ||
+        header.version != CHECKPOINT_VERSION ||
+        header.stateSize != sizeof(State) ||
+        header.boardWidth != BOARD_WIDTH || header.boardHeight != BOARD_HEIGHT ||
+        !file.read(reinterpret_cast<char*>(&loaded), sizeof(State)) ||
+        !isConsistent(loaded)) {
+        return false;
+    }
+    restoreState(loaded);
+    return true;
+}
+
+// Checkpoint bytes come from disk, so everything the game later indexes with
+// or relies on is checked before they are trusted
+template <int Width, int Height>
+bool BasicBlockDropGame<Width, Height>::isConsistent(const State& in) {
+    const int piece = static_cast<int>(in.currentPiece);
+    if (piece < 0 || piece >= PIECE_COUNT || in.rngState == 0) return false;
+    
+    const int rotations = rotationCount(in.currentPiece);
+    if (in.currentRotation < 0 || in.currentRotation >= rotations ||
+        in.targetRotation < 0 || in.targetRotation >= rotations) {
+        return false;
+    }
+    
+    for (int y = 0; y < Height; y++) {
+        uint32_t occupied = 0;
+        for (int x = 0; x < Width; x++) {
+            if (in.board[y][x] > PIECE_COUNT) return false;
+            if (in.board[y][x] != 0) occupied |= 1u << x;
+        }
+        if (in.rows[y] != occupied) return false;
+    }
+    
+    // A live piece must sit where it fits, or locking it would write off the board
+    return in.gameOver || !collides(in.rows, in.currentPiece, in.currentRotation, in.currentX, in.currentY);
+}
+
+template <int Width, int Height>
+void BasicBlockDropGame<Width, Height>::newPiece() {
+    state.currentPiece = randomPiece(state.rngState);
+    state.currentRotation = 0;
+    state.currentX = SPAWN_X;
+    state.currentY = 0;
+    state.autoPlayPositioned = false;  // Reset positioning state for new piece
+    state.autoTimer = 0.0;  // Reset auto-play timer
     
     // Calculate target position for this new piece
-    if (autoPlay) {
+    if (state.autoPlay) {
         auto [bestX, bestRotation] = getBestMove();
-        targetX = bestX;
-        targetRotation = bestRotation;
+        state.targetX = bestX;
+        state.targetRotation = bestRotation;
     }
     
     if (checkCollision()) {
-        gameOver = true;
+        state.gameOver = true;
     }
 }
 
-const std::array<std::string, BlockDropGame::PIECE_SIZE>& BlockDropGame::getCurrentPieceShape() const {
-    return tetrominoes[static_cast<int>(currentPiece)].rotations[currentRotation];
+template <int Width, int Height>
+const std::array<std::string, BlockDropRules::PIECE_SIZE>& BasicBlockDropGame<Width, Height>::getCurrentPieceShape() const {
+    return tetrominoes[static_cast<int>(state.currentPiece)].rotations[state.currentRotation];
 }
 
-bool BlockDropGame::checkCollision(int dx, int dy, int rotation) const {
-    if (rotation == -1) {
-        rotation = currentRotation;
-    }
-    
-    const auto& pieceShape = tetrominoes[static_cast<int>(currentPiece)].rotations[rotation];
-    
-    for (int y = 0; y < PIECE_SIZE; y++) {
-        for (int x = 0; x < PIECE_SIZE; x++) {
-            if (pieceShape[y][x] == '#') {
-                int newX = currentX + x + dx;
-                int newY = currentY + y + dy;
-                
-                if (newX < 0 || newX >= BOARD_WIDTH || 
-                    newY >= BOARD_HEIGHT ||
-                    (newY >= 0 && board[newY][newX])) {
-                    return true;
-                }
-            }
+template <int Width, int Height>
+bool BasicBlockDropGame<Width, Height>::collides(const Rows& rows, const PieceMask& piece, int x, int y) {
+    for (int row = 0; row < PIECE_SIZE; row++) {
+        uint32_t bits = piece.rows[row];
+        if (!bits) continue;
+        
+        // Shift the piece row to column x; bits pushed past either wall collide
+        uint64_t placed;
+        if (x >= 0) {
+            if (x >= Width) return true;
+            placed = uint64_t(bits) << x;
+        } else {
+            if (x <= -PIECE_SIZE || (bits & ((1u << -x) - 1))) return true;
+            placed = bits >> -x;
+        }
+        if (placed & ~uint64_t(FULL_ROW)) return true;
+        
+        int boardY = y + row;
+        if (boardY >= Height || (boardY >= 0 && (rows[boardY] & placed))) {
+            return true;
         }
     }
     return false;
 }
 
-void BlockDropGame::placePiece() {
-    const auto& pieceShape = getCurrentPieceShape();
-    
-    for (int y = 0; y < PIECE_SIZE; y++) {
-        for (int x = 0; x < PIECE_SIZE; x++) {
-            if (pieceShape[y][x] == '#') {
-                int boardX = currentX + x;
-                int boardY = currentY + y;
-                if (boardY >= 0) {
-                    board[boardY][boardX] = static_cast<int>(currentPiece) + 1;
-                }
-            }
+template <int Width, int Height>
+void BasicBlockDropGame<Width, Height>::stamp(Rows& rows, const PieceMask& piece, int x, int y) {
+    for (int row = 0; row < PIECE_SIZE; row++) {
+        int boardY = y + row;
+        if (piece.rows[row] && boardY >= 0) {
+            uint32_t bits = piece.rows[row];
+            rows[boardY] |= static_cast<RowMask>(x >= 0 ? bits << x : bits >> -x);
         }
     }
 }
 
-void BlockDropGame::clearLines() {
-    std::vector<int> linesToClear;
-    
-    for (int y = 0; y < BOARD_HEIGHT; y++) {
-        bool fullLine = true;
-        for (int x = 0; x < BOARD_WIDTH; x++) {
-            if (board[y][x] == 0) {
-                fullLine = false;
-                break;
-            }
+template <int Width, int Height>
+bool BasicBlockDropGame<Width, Height>::collides(const Rows& rows, TetrominoType piece, int rotation, int x, int y) {
+    return collides(rows, pieceMasks[static_cast<int>(piece)][rotation], x, y);
+}
+
+template <int Width, int Height>
+void BasicBlockDropGame<Width, Height>::lockPiece(Rows& rows, Board& board, TetrominoType piece,
+                                                  int rotation, int x, int y) {
+    const PieceMask& mask = pieceMasks[static_cast<int>(piece)][rotation];
+    stamp(rows, mask, x, y);
+    
+    const uint8_t cell = static_cast<uint8_t>(piece) + 1;
+    for (int row = 0; row < PIECE_SIZE; row++) {
+        int boardY = y + row;
+        if (boardY < 0) continue;
+        for (uint32_t bits = mask.rows[row]; bits; bits &= bits - 1) {
+            board[boardY][x + __builtin_ctz(bits)] = cell;
+        }
+    }
+}
+
+template <int Width, int Height>
+bool BasicBlockDropGame<Width, Height>::checkCollision(int dx, int dy, int rotation) const {
+    if (rotation == -1) {
+        rotation = state.currentRotation;
+    }
+    return collides(state.rows, state.currentPiece, rotation, state.currentX + dx, state.currentY + dy);
+}
+
+template <int Width, int Height>
+void BasicBlockDropGame<Width, Height>::placePiece() {
+    lockPiece(state.rows, state.board, state.currentPiece, state.currentRotation,
+              state.currentX, state.currentY);
+}
+
+template <int Width, int Height>
+int BasicBlockDropGame<Width, Height>::clearFullRows(Rows& rows, Board& board) {
+    int clearedCount = 0;
+    
+    // Walk up from the bottom, moving every incomplete row down over the cleared ones
+    int writeY = Height - 1;
+    for (int y = Height - 1; y >= 0; y--) {
+        if (rows[y] == FULL_ROW) {
+            clearedCount++;
+            continue;
         }
-        if (fullLine) {
-            linesToClear.push_back(y);
+        if (writeY != y) {
+            board[writeY] = board[y];
+            rows[writeY] = rows[y];
         }
+        writeY--;
     }
-    
-    for (int y : linesToClear) {
-        board.erase(board.begin() + y);
-        board.insert(board.begin(), std::vector<int>(BOARD_WIDTH, 0));
+    for (; writeY >= 0; writeY--) {
+        board[writeY].fill(0);
+        rows[writeY] = 0;
     }
+    return clearedCount;
+}
+
+template <int Width, int Height>
+void BasicBlockDropGame<Width, Height>::clearLines() {
+    int clearedCount = clearFullRows(state.rows, state.board);
     
-    int clearedCount = linesToClear.size();
-    linesCleared += clearedCount;
-    
+    state.linesCleared += clearedCount;
     if (clearedCount > 0) {
-        score += clearedCount * 100 * level;
-        level = linesCleared / 10 + 1;
-        fallSpeed = std::max(0.1, 0.5 - (level - 1) * 0.05);
+        state.score += lineClearScore(clearedCount, state.level);
+        state.level = state.linesCleared / 10 + 1;
+        state.fallSpeed = fallSpeedForLevel(state.level);
     }
 }
 
-bool BlockDropGame::movePiece(int dx, int dy) {
+template <int Width, int Height>
+bool BasicBlockDropGame<Width, Height>::movePiece(int dx, int dy) {
     if (!checkCollision(dx, dy)) {
-        currentX += dx;
-        currentY += dy;
+        state.currentX += dx;
+        state.currentY += dy;
         return true;
     }
     return false;
 }
 
-void BlockDropGame::rotatePiece() {
-    int newRotation = (currentRotation + 1) % tetrominoes[static_cast<int>(currentPiece)].rotations.size();
+template <int Width, int Height>
+void BasicBlockDropGame<Width, Height>::rotatePiece() {
+    int newRotation = (state.currentRotation + 1) % tetrominoes[static_cast<int>(state.currentPiece)].rotations.size();
     if (!checkCollision(0, 0, newRotation)) {
-        currentRotation = newRotation;
+        state.currentRotation = newRotation;
     }
 }
 
-void BlockDropGame::dropPiece() {
+template <int Width, int Height>
+void BasicBlockDropGame<Width, Height>::dropPiece() {
     if (!movePiece(0, 1)) {
         placePiece();
         clearLines();
@@ -184,266 +400,307 @@ void BlockDropGame::dropPiece() {
     }
 }
 
-void BlockDropGame::hardDrop() {
+template <int Width, int Height>
+void BasicBlockDropGame<Width, Height>::hardDrop() {
     while (movePiece(0, 1)) {
         // Keep dropping
     }
     dropPiece();
 }
 
-int BlockDropGame::getGhostY() const {
-    int ghostY = currentY;
-    while (!checkCollision(0, ghostY - currentY + 1)) {
+template <int Width, int Height>
+int BasicBlockDropGame<Width, Height>::getGhostY() const {
+    int ghostY = state.currentY;
+    while (!checkCollision(0, ghostY - state.currentY + 1)) {
         ghostY++;
     }
     return ghostY;
 }
 
-double BlockDropGame::evaluateBoard() const {
-    double score = 0.0;
+template <int Width, int Height>
+template <uint32_t Features>
+BlockDropRules::BoardFeatures BasicBlockDropGame<Width, Height>::computeFeatures(const Rows& rows) {
+    constexpr bool wantHeights =
+        (Features & (FEATURE_MAX_HEIGHT | FEATURE_AGGREGATE_HEIGHT | FEATURE_BUMPINESS)) != 0;
+    constexpr bool wantCovered = wantHeights || (Features & (FEATURE_HOLES | FEATURE_EMPTY_COLUMNS)) != 0;
+    constexpr bool wantFilled = (Features & (FEATURE_TOTAL_TILES | FEATURE_NEARLY_COMPLETE_ROWS)) != 0;
+    // Without per-row counts the pass can stop once every column has its top block
+    constexpr bool canStopEarly =
+        (Features & (FEATURE_COMPLETE_LINES | FEATURE_HOLES | FEATURE_TOTAL_TILES |
+                     FEATURE_NEARLY_COMPLETE_ROWS)) == 0;
+    
+    BoardFeatures features = {};
+    
+    // One pass from the top: `covered` marks the columns that already have a
+    // block above the current row
+    std::array<int, Width> heights{};
+    uint32_t covered = 0;
+    for (int y = 0; y < Height; y++) {
+        const uint32_t row = rows[y];
+        
+        if constexpr (wantFilled) {
+            const int filledCells = popcount(row);
+            if constexpr ((Features & FEATURE_TOTAL_TILES) != 0) {
+                features.totalTiles += filledCells;
+            }
+            if constexpr ((Features & FEATURE_NEARLY_COMPLETE_ROWS) != 0) {
+                features.nearlyCompleteRows += filledCells >= Width - 1;  // Only very close to complete
+            }
+        }
+        if constexpr ((Features & FEATURE_COMPLETE_LINES) != 0) {
+            features.completeLines += row == FULL_ROW;
+        }
+        
+        // Holes: empty cells below the top block of their column
+        if constexpr ((Features & FEATURE_HOLES) != 0) {
+            features.holes += popcount(covered & ~row);
+        }
+        
+        if constexpr (wantHeights) {
+            for (uint32_t tops = row & ~covered; tops; tops &= tops - 1) {
+                heights[__builtin_ctz(tops)] = Height - y;
+            }
+        }
+        if constexpr (wantCovered) {
+            covered |= row;
+            if constexpr (canStopEarly) {
+                if (covered == FULL_ROW) break;
+            }
+        }
+    }
     
-    // Calculate column heights
-    std::vector<int> heights(BOARD_WIDTH, 0);
-    for (int x = 0; x < BOARD_WIDTH; x++) {
-        for (int y = 0; y < BOARD_HEIGHT; y++) {
-            if (board[y][x]) {
-                heights[x] = BOARD_HEIGHT - y;
-                break;
+    if constexpr ((Features & FEATURE_EMPTY_COLUMNS) != 0) {
+        features.emptyColumns = Width - popcount(covered);
+    }
+    if constexpr ((Features & FEATURE_MAX_HEIGHT) != 0) {
+        features.maxHeight = *std::max_element(heights.begin(), heights.end());
+    }
+    if constexpr ((Features & (FEATURE_AGGREGATE_HEIGHT | FEATURE_BUMPINESS)) != 0) {
+        for (int x = 0; x < Width; x++) {
+            if constexpr ((Features & FEATURE_AGGREGATE_HEIGHT) != 0) {
+                features.aggregateHeight += heights[x];
+            }
+            if constexpr ((Features & FEATURE_BUMPINESS) != 0) {
+                if (x + 1 < Width) {
+                    features.bumpiness += std::abs(heights[x] - heights[x + 1]);
+                }
             }
         }
     }
     
+    return features;
+}
+
+template <int Width, int Height>
+BlockDropRules::BoardFeatures BasicBlockDropGame<Width, Height>::computeFeatures(const Rows& rows) {
+    return computeFeatures<ALL_FEATURES>(rows);
+}
+
+template <int Width, int Height>
+typename BasicBlockDropGame<Width, Height>::FeatureKernel
+BasicBlockDropGame<Width, Height>::featureKernel(uint32_t features) {
+    static const auto kernels = featureKernelTable<BasicBlockDropGame>(
+        std::make_index_sequence<ALL_FEATURES + 1>());
+    return kernels[features & ALL_FEATURES];
+}
+
+template <int Width, int Height>
+double BasicBlockDropGame<Width, Height>::scoreFeatures(const BoardFeatures& features) {
+    // configs/heuristic.cfg repeats these terms in this order; keep them in step
+    double score = 0.0;
+    
     // Maximum height penalty (CRITICAL - avoid game over)
-    int maxHeight = *std::max_element(heights.begin(), heights.end());
-    if (maxHeight > 18) {
+    // Thresholds are measured from the top, so taller boards get the same margins
+    int maxHeight = features.maxHeight;
+    if (maxHeight > Height - 2) {
         score -= 1000.0;  // Extreme penalty for dangerous heights
-    } else if (maxHeight > 15) {
-        score -= (maxHeight - 15) * 50.0;  // Heavy penalty for risky heights
-    } else if (maxHeight > 12) {
-        score -= (maxHeight - 12) * 10.0;  // Moderate penalty for medium heights
+    } else if (maxHeight > Height - 5) {
+        score -= (maxHeight - (Height - 5)) * 50.0;  // Heavy penalty for risky heights
+    } else if (maxHeight > Height - 8) {
+        score -= (maxHeight - (Height - 8)) * 10.0;  // Moderate penalty for medium heights
     }
     
     // Aggregate height penalty (increased for safety)
-    int aggregateHeight = 0;
-    for (int height : heights) {
-        aggregateHeight += height;
-    }
-    score -= aggregateHeight * 0.6;  // Increased penalty to keep board lower
-    
-    // Complete lines bonus (linear, not exponential for safety)
-    int completeLines = 0;
-    for (int y = 0; y < BOARD_HEIGHT; y++) {
-        bool complete = true;
-        for (int x = 0; x < BOARD_WIDTH; x++) {
-            if (!board[y][x]) {
-                complete = false;
-                break;
-            }
-        }
-        if (complete) completeLines++;
-    }
+    score -= features.aggregateHeight * 0.6;  // Increased penalty to keep board lower
+    
     // Linear bonus - prioritize any line clear over risky play
-    score += completeLines * 10.0;  // Good bonus but not overwhelming
+    score += features.completeLines * 10.0;  // Good bonus but not overwhelming
     
     // Holes penalty (very severe - holes are dangerous)
-    int holes = 0;
-    for (int x = 0; x < BOARD_WIDTH; x++) {
-        bool foundBlock = false;
-        for (int y = 0; y < BOARD_HEIGHT; y++) {
-            if (board[y][x]) {
-                foundBlock = true;
-            } else if (foundBlock) {
-                holes++;
-            }
-        }
-    }
-    score -= holes * 5.0;  // Very high penalty for holes
+    score -= features.holes * 5.0;  // Very high penalty for holes
     
     // Bumpiness penalty (increased for safety)
-    int bumpiness = 0;
-    for (int x = 0; x < BOARD_WIDTH - 1; x++) {
-        bumpiness += std::abs(heights[x] - heights[x + 1]);
-    }
-    score -= bumpiness * 0.8;  // Higher penalty for uneven surface
+    score -= features.bumpiness * 0.8;  // Higher penalty for uneven surface
     
     // Safety bonus for low, flat board
     if (maxHeight <= 8) {
         score += 5.0;  // Bonus for keeping board low
     }
-    if (bumpiness <= 3) {
+    if (features.bumpiness <= 3) {
         score += 3.0;  // Bonus for flat surface
     }
     
     // Count total tiles on board (encourage clearing)
-    int totalTiles = 0;
-    for (int y = 0; y < BOARD_HEIGHT; y++) {
-        for (int x = 0; x < BOARD_WIDTH; x++) {
-            if (board[y][x]) {
-                totalTiles++;
-            }
-        }
-    }
-    score -= totalTiles * 0.05;  // Small penalty for tiles
+    score -= features.totalTiles * 0.05;  // Small penalty for tiles
     
     // Bonus for almost complete lines (but only if safe)
-    if (maxHeight <= 15) {  // Only encourage this if board is safe
-        for (int y = 0; y < BOARD_HEIGHT; y++) {
-            int filledCells = 0;
-            for (int x = 0; x < BOARD_WIDTH; x++) {
-                if (board[y][x]) {
-                    filledCells++;
-                }
-            }
-            if (filledCells >= 9) {  // Only very close to complete
-                score += 1.0;  // Small bonus for nearly complete lines
-            }
-        }
+    if (maxHeight <= Height - 5) {  // Only encourage this if board is safe
+        score += features.nearlyCompleteRows * 1.0;  // Small bonus for nearly complete lines
     }
     
-    // Penalty for empty columns
-    for (int x = 0; x < BOARD_WIDTH; x++) {
-        bool columnEmpty = true;
-        for (int y = BOARD_HEIGHT - 1; y >= 0; y--) {
-            if (board[y][x]) {
-                columnEmpty = false;
-                break;
-            }
-        }
-        if (columnEmpty && maxHeight > 5) {
-            // Penalty for empty columns when there's significant height
-            score -= 1.0;  // Equal penalty for all empty columns
-        }
+    // Penalty for empty columns when there's significant height
+    if (maxHeight > 5) {
+        score -= features.emptyColumns * 1.0;  // Equal penalty for all empty columns
     }
     
     return score;
 }
 
-std::pair<int, int> BlockDropGame::getBestMove() const {
-    double bestScore = -1e9;
-    int bestX = currentX;
-    int bestRotation = currentRotation;
-    
-    // Save current state
-    int oldX = currentX, oldY = currentY, oldRotation = currentRotation;
-    auto oldBoard = board;
-    
-    for (size_t rotation = 0; rotation < tetrominoes[static_cast<int>(currentPiece)].rotations.size(); rotation++) {
+template <int Width, int Height>
+double BasicBlockDropGame<Width, Height>::evaluateBoard() const {
+    return scoreFeatures(computeFeatures(state.rows));
+}
+
+template <int Width, int Height>
+void BasicBlockDropGame<Width, Height>::searchMoves(const Rows& rows, TetrominoType type,
+                                                    const Evaluator* evaluator,
+                                                    std::vector<MoveCandidate>& out,
+                                                    uint32_t extraFeatures) {
+    out.clear();
+    
+    // Only the features the evaluator reads, and any extra ones asked for, are computed
+    const FeatureKernel kernel = featureKernel(
+        (evaluator ? evaluator->getFeatureMask() : ALL_FEATURES) | extraFeatures);
+    
+    // Placements are simulated on a copy of the occupancy rows
+    Rows placed;
+    for (int rotation = 0; rotation < rotationCount(type); rotation++) {
+        const PieceMask& piece = pieceMasks[static_cast<int>(type)][rotation];
+        
         // Expand search range to include positions where piece extends beyond left edge
         for (int x = -2; x <= BOARD_WIDTH + 1; x++) {
-            // Simulate placement
-            const_cast<BlockDropGame*>(this)->currentX = x;
-            const_cast<BlockDropGame*>(this)->currentRotation = rotation;
-            const_cast<BlockDropGame*>(this)->currentY = 0;
-            
             // Check if this position is valid at the top
-            if (!checkCollision()) {
-                int ghostY = getGhostY();
-                const_cast<BlockDropGame*>(this)->currentY = ghostY;
-                
-                // Final collision check at ghost position
-                if (!checkCollision()) {
-                    const_cast<BlockDropGame*>(this)->placePiece();
-                    double score = evaluateBoard();
-                    
-                    if (score > bestScore) {
-                        bestScore = score;
-                        bestX = x;
-                        bestRotation = rotation;
-                    }
-                    
-                    // Restore board
-                    const_cast<BlockDropGame*>(this)->board = oldBoard;
-                }
+            if (collides(rows, piece, x, 0)) continue;
+            
+            int ghostY = 0;
+            while (!collides(rows, piece, x, ghostY + 1)) {
+                ghostY++;
             }
+            
+            placed = rows;
+            stamp(placed, piece, x, ghostY);
+            BoardFeatures features = kernel(placed);
+            out.push_back({x, rotation, features, evaluator ? 0.0 : scoreFeatures(features)});
         }
     }
     
-    // If no valid move found, try to find any valid position
-    if (bestScore == -1e9) {
-        for (size_t rotation = 0; rotation < tetrominoes[static_cast<int>(currentPiece)].rotations.size(); rotation++) {
-            for (int x = -2; x <= BOARD_WIDTH + 1; x++) {
-                const_cast<BlockDropGame*>(this)->currentX = x;
-                const_cast<BlockDropGame*>(this)->currentRotation = rotation;
-                const_cast<BlockDropGame*>(this)->currentY = 0;
-                
-                if (!checkCollision()) {
-                    bestX = x;
-                    bestRotation = rotation;
-                    break;
-                }
-            }
-            if (bestScore != -1e9) break;
-        }
+    // Learned evaluators score every candidate in one batch
+    if (evaluator) {
+        evaluator->scoreMoves(out.data(), out.size());
     }
+}
+
+template <int Width, int Height>
+void BasicBlockDropGame<Width, Height>::evaluateMoves(std::vector<MoveCandidate>& out,
+                                                      uint32_t extraFeatures) const {
+    searchMoves(state.rows, state.currentPiece, evaluator.get(), out, extraFeatures);
+}
+
+template <int Width, int Height>
+bool BasicBlockDropGame<Width, Height>::placeAt(int x, int rotation) {
+    if (state.gameOver) return false;
     
-    // Restore state
-    const_cast<BlockDropGame*>(this)->currentX = oldX;
-    const_cast<BlockDropGame*>(this)->currentY = oldY;
-    const_cast<BlockDropGame*>(this)->currentRotation = oldRotation;
-    
-    return {bestX, bestRotation};
+    int oldX = state.currentX, oldRotation = state.currentRotation;
+    state.currentX = x;
+    state.currentRotation = rotation;
+    if (checkCollision()) {
+        state.currentX = oldX;
+        state.currentRotation = oldRotation;
+        return false;
+    }
+    hardDrop();
+    return true;
+}
+
+template <int Width, int Height>
+std::pair<int, int> BasicBlockDropGame<Width, Height>::getBestMove() const {
+    evaluateMoves(candidates);
+    if (candidates.empty()) {
+        // No valid placement: stay put, the game is about to end
+        return {state.currentX, state.currentRotation};
+    }
+    
+    size_t best = 0;
+    for (size_t i = 1; i < candidates.size(); i++) {
+        if (candidates[i].score > candidates[best].score) {
+            best = i;
+        }
+    }
+    return {candidates[best].x, candidates[best].rotation};
 }
 
-void BlockDropGame::autoPlayStep() {
-    if (gameOver || autoPlayPositioned) return;  // Don't adjust if already positioned
+template <int Width, int Height>
+void BasicBlockDropGame<Width, Height>::autoPlayStep() {
+    if (state.gameOver || state.autoPlayPositioned) return;  // Don't adjust if already positioned
     
     // Verify target position is still valid
-    int oldX = currentX, oldY = currentY, oldRotation = currentRotation;
-    currentX = targetX;
-    currentRotation = targetRotation;
+    int oldX = state.currentX, oldY = state.currentY, oldRotation = state.currentRotation;
+    state.currentX = state.targetX;
+    state.currentRotation = state.targetRotation;
     
     if (checkCollision()) {
         // Target position is no longer valid, recalculate
-        currentX = oldX;
-        currentY = oldY;
-        currentRotation = oldRotation;
+        state.currentX = oldX;
+        state.currentY = oldY;
+        state.currentRotation = oldRotation;
         auto [newX, newRotation] = getBestMove();
-        targetX = newX;
-        targetRotation = newRotation;
+        state.targetX = newX;
+        state.targetRotation = newRotation;
     } else {
         // Restore current position
-        currentX = oldX;
-        currentY = oldY;
-        currentRotation = oldRotation;
+        state.currentX = oldX;
+        state.currentY = oldY;
+        state.currentRotation = oldRotation;
     }
     
     // Use cached target position to avoid recalculation
-    if (currentRotation != targetRotation) {
+    if (state.currentRotation != state.targetRotation) {
         rotatePiece();
-    } else if (currentX < targetX) {
+    } else if (state.currentX < state.targetX) {
         if (!movePiece(1, 0)) {
             // Can't move right, consider positioned
-            autoPlayPositioned = true;
+            state.autoPlayPositioned = true;
         }
-    } else if (currentX > targetX) {
+    } else if (state.currentX > state.targetX) {
         if (!movePiece(-1, 0)) {
             // Can't move left, consider positioned
-            autoPlayPositioned = true;
+            state.autoPlayPositioned = true;
         }
     } else {
         // Position and rotation are correct, mark as positioned for faster falling
-        autoPlayPositioned = true;
+        state.autoPlayPositioned = true;
     }
 }
 
-void BlockDropGame::update(double deltaTime) {
-    if (gameOver) return;
+template <int Width, int Height>
+void BasicBlockDropGame<Width, Height>::update(double deltaTime) {
+    if (state.gameOver) return;
     
-    if (autoPlay && !autoPlayPositioned) {
-        autoTimer += deltaTime;
-        if (autoTimer >= 0.1) {
+    if (state.autoPlay && !state.autoPlayPositioned) {
+        state.autoTimer += deltaTime;
+        if (state.autoTimer >= 0.1) {
             autoPlayStep();
-            autoTimer = 0.0;
+            state.autoTimer = 0.0;
         }
         // Do not update fallTime when positioning in auto-play mode
         return;
     }
     
-    fallTime += deltaTime;
+    state.fallTime += deltaTime;
     double currentFallSpeed;
     
-    if (autoPlay) {
-        if (autoPlayPositioned) {
+    if (state.autoPlay) {
+        if (state.autoPlayPositioned) {
             // Fast fall when position is finalized
             currentFallSpeed = 0.02;
         } else {
@@ -452,24 +709,25 @@ void BlockDropGame::update(double deltaTime) {
         }
     } else {
         // Manual play speed
-        currentFallSpeed = fallSpeed;
+        currentFallSpeed = state.fallSpeed;
     }
     
-    if (fallTime >= currentFallSpeed) {
+    if (state.fallTime >= currentFallSpeed) {
         dropPiece(); // Both manual and auto-play use natural falling
-        fallTime = 0.0;
+        state.fallTime = 0.0;
     }
 }
 
-void BlockDropGame::handleInput(char key) {
-    if (gameOver) return;
+template <int Width, int Height>
+void BasicBlockDropGame<Width, Height>::handleInput(char key) {
+    if (state.gameOver) return;
     
     if (key == 't' || key == 'T') {
         toggleAutoPlay();
         return;
     }
     
-    if (autoPlay) return;
+    if (state.autoPlay) return;
     
     switch (key) {
         case 'a': case 'A':
@@ -488,4 +746,7 @@ void BlockDropGame::handleInput(char key) {
             hardDrop();
             break;
     }
-}
\ No newline at end of file
+}
+
+#define BLOCKDROP_INSTANTIATE_GAME(width, height) template class BasicBlockDropGame<width, height>;
+BLOCKDROP_GEOMETRIES(BLOCKDROP_INSTANTIATE_GAME)
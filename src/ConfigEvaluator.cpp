@@ -0,0 +1,204 @@
+#include "ConfigEvaluator.h"
+#include <chrono>
+#include <climits>
+#include <fstream>
+#include <iostream>
+#include <sstream>
+#include <sys/stat.h>
+
+namespace {
+
+// In BoardFeatures member order, matching the FeatureBit values
+const char* FEATURE_NAMES[BlockDropGame::FEATURE_COUNT] = {
+    "max_height", "aggregate_height", "complete_lines", "holes",
+    "bumpiness", "total_tiles", "nearly_complete_rows", "empty_columns"
+};
+
+// Index into FEATURE_NAMES, or FEATURE_COUNT if `name` is not a feature
+int findFeature(const std::string& name) {
+    int feature = 0;
+    while (feature < BlockDropGame::FEATURE_COUNT && name != FEATURE_NAMES[feature]) {
+        feature++;
+    }
+    return feature;
+}
+
+// A number, or top-N for N rows below the top of a board of `boardHeight` rows
+bool parseThreshold(const std::string& text, int boardHeight, int& out) {
+    const bool fromTop = text.compare(0, 4, "top-") == 0;
+    const std::string digits = fromTop ? text.substr(4) : text;
+    size_t used = 0;
+    try {
+        out = std::stoi(digits, &used);
+    } catch (const std::exception&) {
+        return false;
+    }
+    if (used != digits.size()) return false;
+    if (fromTop) out = boardHeight - out;
+    return true;
+}
+
+// Returns -1 if the file cannot be stat'ed
+int64_t modificationTime(const std::string& path) {
+    struct stat info;
+    if (stat(path.c_str(), &info) != 0) {
+        return -1;
+    }
+    return static_cast<int64_t>(info.st_mtim.tv_sec) * 1000000000 + info.st_mtim.tv_nsec;
+}
+
+int64_t steadyNow() {
+    return std::chrono::steady_clock::now().time_since_epoch().count();
+}
+
+} // namespace
+
+ConfigEvaluator::ConfigEvaluator() : featureMask(0) {
+}
+
+bool ConfigEvaluator::load(const std::string& path, int boardHeight) {
+    std::ifstream in(path);
+    if (!in) {
+        std::cerr << "Could not open evaluator config " << path << std::endl;
+        return false;
+    }
+
+    std::vector<Term> loaded;
+    uint32_t mask = 0;
+    std::string line;
+    for (int lineNumber = 1; std::getline(in, line); lineNumber++) {
+        line = line.substr(0, line.find('#'));
+        std::istringstream fields(line);
+        std::string name, word;
+        Term term{0, 0.0, 0, {}};
+        if (!(fields >> name)) continue;  // Blank or comment
+
+        term.feature = name == "constant" ? CONSTANT : findFeature(name);
+        if (term.feature == BlockDropGame::FEATURE_COUNT && name != "constant") {
+            std::cerr << path << ":" << lineNumber << ": unknown feature " << name << std::endl;
+            return false;
+        }
+        if (!(fields >> term.weight)) {
+            std::cerr << path << ":" << lineNumber << ": expected \"" << name << " <weight>\"" << std::endl;
+            return false;
+        }
+
+        bool valid = true;
+        if (fields >> word && word == "minus") {
+            valid = fields >> word && parseThreshold(word, boardHeight, term.offset);
+            if (!(fields >> word)) word.clear();
+        }
+        if (valid && word == "if") {
+            do {
+                std::string conditionName, op, threshold;
+                Condition condition{0, INT_MIN, INT_MAX};
+                int value = 0;
+                valid = fields >> conditionName >> op >> threshold &&
+                        parseThreshold(threshold, boardHeight, value);
+                condition.feature = findFeature(conditionName);
+                if (!valid || condition.feature == BlockDropGame::FEATURE_COUNT) {
+                    valid = false;
+                } else if (op == "<") {
+                    condition.max = value - 1;
+                } else if (op == "<=") {
+                    condition.max = value;
+                } else if (op == ">") {
+                    condition.min = value + 1;
+                } else if (op == ">=") {
+                    condition.min = value;
+                } else {
+                    valid = false;
+                }
+                term.conditions.push_back(condition);
+                mask |= 1u << condition.feature;
+            } while (valid && fields >> word && word == "and");
+            if (valid && fields) valid = false;  // Trailing word other than "and"
+        } else if (valid && !word.empty()) {
+            valid = false;
+        }
+        if (!valid) {
+            std::cerr << path << ":" << lineNumber << ": expected \"" << name
+                      << " <weight> [minus <threshold>] [if <feature> <op> <threshold> [and ...]]\"" << std::endl;
+            return false;
+        }
+
+        if (term.feature != CONSTANT) {
+            mask |= 1u << term.feature;
+        }
+        loaded.push_back(std::move(term));
+    }
+    if (mask == 0) {
+        std::cerr << path << " enables no features" << std::endl;
+        return false;
+    }
+
+    terms = std::move(loaded);
+    featureMask = mask;
+    return true;
+}
+
+void ConfigEvaluator::scoreMoves(BlockDropGame::MoveCandidate* candidates, size_t count) const {
+    for (size_t n = 0; n < count; n++) {
+        const auto& f = candidates[n].features;
+        const int values[BlockDropGame::FEATURE_COUNT + 1] = {
+            f.maxHeight, f.aggregateHeight, f.completeLines, f.holes,
+            f.bumpiness, f.totalTiles, f.nearlyCompleteRows, f.emptyColumns,
+            1  // CONSTANT
+        };
+        double score = 0.0;
+        for (const Term& term : terms) {
+            bool applies = true;
+            for (const Condition& condition : term.conditions) {
+                const int value = values[condition.feature];
+                applies &= value >= condition.min && value <= condition.max;
+            }
+            if (applies) {
+                score += term.weight * (values[term.feature] - term.offset);
+            }
+        }
+        candidates[n].score = score;
+    }
+}
+
+ConfigReloader::ConfigReloader(const std::string& path, int boardHeight)
+    : path(path), boardHeight(boardHeight), nextCheck(0), loadedModified(-1)
+{
+}
+
+bool ConfigReloader::load() {
+    int64_t modified = modificationTime(path);
+    auto loaded = std::make_shared<ConfigEvaluator>();
+    if (!loaded->load(path, boardHeight)) {
+        return false;
+    }
+    loadedModified.store(modified, std::memory_order_relaxed);
+    std::atomic_store(&evaluator, std::shared_ptr<const ConfigEvaluator>(std::move(loaded)));
+    nextCheck.store(steadyNow(), std::memory_order_release);
+    return true;
+}
+
+std::shared_ptr<const Evaluator> ConfigReloader::current() {
+    const int64_t interval = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::milliseconds(CHECK_INTERVAL_MS)).count();
+    int64_t now = steadyNow();
+    int64_t due = nextCheck.load(std::memory_order_acquire);
+    if (now >= due && nextCheck.compare_exchange_strong(due, now + interval, std::memory_order_acq_rel)) {
+        reloadIfChanged();
+    }
+    return std::atomic_load(&evaluator);
+}
+
+void ConfigReloader::reloadIfChanged() {
+    int64_t modified = modificationTime(path);
+    // Checks can overlap when a load outlasts CHECK_INTERVAL_MS; the exchange
+    // lets only one of them load a given version. It is remembered even if it
+    // fails to load, so a broken edit is reported once rather than on every check.
+    if (modified < 0 || loadedModified.exchange(modified, std::memory_order_relaxed) == modified) return;
+    auto loaded = std::make_shared<ConfigEvaluator>();
+    if (!loaded->load(path, boardHeight)) {
+        std::cerr << "Keeping the previous evaluator config" << std::endl;
+        return;
+    }
+    std::atomic_store(&evaluator, std::shared_ptr<const ConfigEvaluator>(std::move(loaded)));
+    std::cerr << "Reloaded evaluator config " << path << std::endl;
+}
@@ -0,0 +1,107 @@
+#include "GameGrid.h"
+#include <algorithm>
+#include <chrono>
+
+GameGrid::GameGrid(int gameCount, double tickTime)
+    : running(false), tickTime(tickTime)
+{
+    slots.reserve(gameCount);
+    for (int i = 0; i < gameCount; i++) {
+        auto slot = std::make_unique<Slot>();
+        slot->game.toggleAutoPlay();
+        slot->writeIndex = 0;
+        slot->shared.store(1, std::memory_order_relaxed);
+        slot->readIndex = 2;
+        // Fill every buffer so the renderer sees the starting board right away
+        publish(*slot);
+        slot->buffers[slot->readIndex] = slot->buffers[slot->shared.load() & ~FRESH_BIT];
+        slots.push_back(std::move(slot));
+    }
+}
+
+GameGrid::~GameGrid() {
+    stop();
+}
+
+void GameGrid::start(int threadCount) {
+    if (running.exchange(true)) return;
+
+    int count = size();
+    threadCount = std::max(1, std::min(threadCount, count));
+    for (int t = 0; t < threadCount; t++) {
+        int first = count * t / threadCount;
+        int last = count * (t + 1) / threadCount;
+        workers.emplace_back(&GameGrid::workerLoop, this, first, last);
+    }
+}
+
+void GameGrid::stop() {
+    running = false;
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+const BoardSnapshot& GameGrid::acquireSnapshot(int index) {
+    Slot& slot = *slots[index];
+    if (slot.shared.load(std::memory_order_relaxed) & FRESH_BIT) {
+        int previous = slot.shared.exchange(slot.readIndex, std::memory_order_acq_rel);
+        slot.readIndex = previous & ~FRESH_BIT;
+    }
+    return slot.buffers[slot.readIndex];
+}
+
+void GameGrid::workerLoop(int first, int last) {
+    auto tickDuration = std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+        std::chrono::duration<double>(tickTime));
+    auto nextTick = std::chrono::steady_clock::now();
+
+    while (running.load(std::memory_order_relaxed)) {
+        for (int i = first; i < last; i++) {
+            Slot& slot = *slots[i];
+            if (slot.game.isGameOver()) continue;
+            slot.game.update(tickTime);
+            publish(slot);
+        }
+
+        nextTick += tickDuration;
+        std::this_thread::sleep_until(nextTick);
+    }
+}
+
+void GameGrid::publish(Slot& slot) {
+    const BlockDropGame& game = slot.game;
+    BoardSnapshot& snapshot = slot.buffers[slot.writeIndex];
+
+    const auto& board = game.getBoard();
+    for (int y = 0; y < BlockDropGame::BOARD_HEIGHT; y++) {
+        for (int x = 0; x < BlockDropGame::BOARD_WIDTH; x++) {
+            snapshot.cells[y][x] = static_cast<uint8_t>(board[y][x]);
+        }
+    }
+
+    if (!game.isGameOver()) {
+        const auto& pieceShape = game.getCurrentPieceShape();
+        uint8_t pieceValue = static_cast<uint8_t>(game.getCurrentPieceType()) + 1;
+        for (int y = 0; y < BlockDropGame::PIECE_SIZE; y++) {
+            for (int x = 0; x < BlockDropGame::PIECE_SIZE; x++) {
+                int boardX = game.getCurrentX() + x;
+                int boardY = game.getCurrentY() + y;
+                if (pieceShape[y][x] == '#' &&
+                    boardX >= 0 && boardX < BlockDropGame::BOARD_WIDTH &&
+                    boardY >= 0 && boardY < BlockDropGame::BOARD_HEIGHT) {
+                    snapshot.cells[boardY][boardX] = pieceValue;
+                }
+            }
+        }
+    }
+
+    snapshot.score = game.getScore();
+    snapshot.level = game.getLevel();
+    snapshot.linesCleared = game.getLinesCleared();
+    snapshot.gameOver = game.isGameOver();
+
+    int previous = slot.shared.exchange(slot.writeIndex | FRESH_BIT, std::memory_order_acq_rel);
+    slot.writeIndex = previous & ~FRESH_BIT;
+}
@@ -0,0 +1,105 @@
+#include "LatencyTracker.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace {
+
+const char* STAGE_NAMES[LatencyTracker::STAGE_COUNT] = {
+    "dequeued", "handled", "state change", "presented"
+};
+
+} // namespace
+
+LatencyHistogram::LatencyHistogram() : buckets{}, total(0), maximum(0.0) {
+}
+
+void LatencyHistogram::record(double milliseconds) {
+    int bucket = 0;
+    if (milliseconds > MIN_MS) {
+        bucket = static_cast<int>(std::log(milliseconds / MIN_MS) / std::log(GROWTH)) + 1;
+        bucket = std::min(bucket, BUCKET_COUNT - 1);
+    }
+    buckets[bucket]++;
+    total++;
+    maximum = std::max(maximum, milliseconds);
+}
+
+void LatencyHistogram::merge(const LatencyHistogram& other) {
+    for (int i = 0; i < BUCKET_COUNT; i++) {
+        buckets[i] += other.buckets[i];
+    }
+    total += other.total;
+    maximum = std::max(maximum, other.maximum);
+}
+
+double LatencyHistogram::percentile(double p) const {
+    if (total == 0) return 0.0;
+
+    uint64_t rank = static_cast<uint64_t>(p * (total - 1) + 0.5);
+    uint64_t seen = 0;
+    int bucket = 0;
+    while (bucket < BUCKET_COUNT - 1 && (seen += buckets[bucket]) <= rank) {
+        bucket++;
+    }
+    if (bucket == 0) return std::min(MIN_MS, maximum);
+
+    // Geometric middle of the bucket, never beyond the largest sample
+    double middle = MIN_MS * std::pow(GROWTH, bucket - 0.5);
+    return std::min(middle, maximum);
+}
+
+LatencyTracker::LatencyTracker() : pendingCount(0) {
+}
+
+void LatencyTracker::inputReceived(Clock::duration eventAge) {
+    Clock::time_point now = Clock::now();
+    Clock::time_point eventTime = now - eventAge;
+
+    if (pendingCount < MAX_PENDING) {
+        pending[pendingCount++].eventTime = eventTime;
+    }
+    latestEventTime = eventTime;
+    record(DEQUEUED, eventTime, now);
+}
+
+void LatencyTracker::inputHandled(bool stateChanged) {
+    if (pendingCount == 0) return;
+
+    Clock::time_point now = Clock::now();
+    record(HANDLED, latestEventTime, now);
+    if (stateChanged) {
+        record(STATE_CHANGED, latestEventTime, now);
+    }
+}
+
+void LatencyTracker::framePresented() {
+    Clock::time_point now = Clock::now();
+    for (int i = 0; i < pendingCount; i++) {
+        record(PRESENTED, pending[i].eventTime, now);
+    }
+    pendingCount = 0;
+}
+
+void LatencyTracker::record(Stage stage, Clock::time_point eventTime, Clock::time_point now) {
+    samples[stage].record(std::chrono::duration<double, std::milli>(now - eventTime).count());
+}
+
+void LatencyTracker::report(std::ostream& out) const {
+    out << "Input latency (ms since key event, " << samples[DEQUEUED].count() << " inputs)\n";
+    out << std::left << std::setw(14) << "stage"
+        << std::right << std::setw(8) << "p50" << std::setw(8) << "p90"
+        << std::setw(8) << "p99" << std::setw(8) << "max" << "\n";
+
+    for (int stage = 0; stage < STAGE_COUNT; stage++) {
+        const LatencyHistogram& histogram = samples[stage];
+        if (histogram.count() == 0) continue;
+
+        out << std::left << std::setw(14) << STAGE_NAMES[stage] << std::right << std::fixed
+            << std::setprecision(2)
+            << std::setw(8) << histogram.percentile(0.50)
+            << std::setw(8) << histogram.percentile(0.90)
+            << std::setw(8) << histogram.percentile(0.99)
+            << std::setw(8) << histogram.max() << "\n";
+    }
+}
@@ -0,0 +1,285 @@
+#include "NeuralEvaluator.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define BLOCKDROP_X86_KERNELS 1
+#include <immintrin.h>
+#endif
+
+namespace {
+
+const uint32_t MODEL_VERSION = 1;
+const int BLOCK = 32;  // Bytes per AVX2 register; rows are padded to it
+const int ACTIVATION_MAX = 127;
+
+void layerScalar(const uint8_t* inputs, size_t batch, int stride,
+                 const int8_t* weights, const int32_t* bias, int outputs,
+                 int32_t* accumulators) {
+    for (int j = 0; j < outputs; j++) {
+        const int8_t* row = weights + static_cast<size_t>(j) * stride;
+        for (size_t n = 0; n < batch; n++) {
+            const uint8_t* x = inputs + n * stride;
+            int32_t sum = bias[j];
+            for (int i = 0; i < stride; i++) {
+                sum += x[i] * row[i];
+            }
+            accumulators[n * outputs + j] = sum;
+        }
+    }
+}
+
+#ifdef BLOCKDROP_X86_KERNELS
+
+// Eight partial sums of one row pair of `stride` bytes
+__attribute__((target("avx2")))
+inline __m256i dotAvx2(const uint8_t* x, const int8_t* row, int stride, __m256i ones) {
+    __m256i sum = _mm256_setzero_si256();
+    for (int i = 0; i < stride; i += BLOCK) {
+        __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x + i));
+        __m256i b = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row + i));
+        sum = _mm256_add_epi32(sum, _mm256_madd_epi16(_mm256_maddubs_epi16(a, b), ones));
+    }
+    return sum;
+}
+
+// Same for a one-block row already held in a register
+__attribute__((target("avx2")))
+inline __m256i dotAvx2(const uint8_t* x, __m256i row, __m256i ones) {
+    __m256i a = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(x));
+    return _mm256_madd_epi16(_mm256_maddubs_epi16(a, row), ones);
+}
+
+__attribute__((target("avx2")))
+void layerAvx2(const uint8_t* inputs, size_t batch, int stride,
+               const int8_t* weights, const int32_t* bias, int outputs,
+               int32_t* accumulators) {
+    const __m256i ones = _mm256_set1_epi16(1);
+    alignas(16) int32_t sums[4];
+    for (int j = 0; j < outputs; j++) {
+        const int8_t* row = weights + static_cast<size_t>(j) * stride;
+        size_t n = 0;
+
+        // Rows of one block (up to 32 inputs, the usual case): the weight row
+        // stays in a register while four candidates at a time stream past it
+        if (stride == BLOCK) {
+            const __m256i w = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(row));
+            for (; n + 4 <= batch; n += 4) {
+                const uint8_t* x = inputs + n * BLOCK;
+                __m256i s = _mm256_hadd_epi32(
+                    _mm256_hadd_epi32(dotAvx2(x, w, ones), dotAvx2(x + BLOCK, w, ones)),
+                    _mm256_hadd_epi32(dotAvx2(x + 2 * BLOCK, w, ones), dotAvx2(x + 3 * BLOCK, w, ones)));
+                __m128i total = _mm_add_epi32(_mm256_castsi256_si128(s), _mm256_extracti128_si256(s, 1));
+                _mm_store_si128(reinterpret_cast<__m128i*>(sums), _mm_add_epi32(total, _mm_set1_epi32(bias[j])));
+                for (int k = 0; k < 4; k++) {
+                    accumulators[(n + k) * outputs + j] = sums[k];
+                }
+            }
+        }
+
+        // Longer rows, and the tail of the batch
+        for (; n < batch; n++) {
+            __m256i sum = dotAvx2(inputs + n * stride, row, stride, ones);
+            __m128i s = _mm_add_epi32(_mm256_castsi256_si128(sum), _mm256_extracti128_si256(sum, 1));
+            s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0x4E));
+            s = _mm_add_epi32(s, _mm_shuffle_epi32(s, 0xB1));
+            accumulators[n * outputs + j] = bias[j] + _mm_cvtsi128_si32(s);
+        }
+    }
+}
+
+__attribute__((target("ssse3")))
+inline __m128i dotSsse3(const uint8_t* x, const int8_t* row, int stride, __m128i ones) {
+    __m128i sum = _mm_setzero_si128();
+    for (int i = 0; i < stride; i += 16) {
+        __m128i a = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + i));
+        __m128i b = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + i));
+        sum = _mm_add_epi32(sum, _mm_madd_epi16(_mm_maddubs_epi16(a, b), ones));
+    }
+    return sum;
+}
+
+__attribute__((target("ssse3")))
+inline __m128i dotSsse3(const uint8_t* x, __m128i row0, __m128i row1, __m128i ones) {
+    __m128i a0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x));
+    __m128i a1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(x + 16));
+    return _mm_add_epi32(_mm_madd_epi16(_mm_maddubs_epi16(a0, row0), ones),
+                         _mm_madd_epi16(_mm_maddubs_epi16(a1, row1), ones));
+}
+
+__attribute__((target("ssse3")))
+void layerSsse3(const uint8_t* inputs, size_t batch, int stride,
+                const int8_t* weights, const int32_t* bias, int outputs,
+                int32_t* accumulators) {
+    const __m128i ones = _mm_set1_epi16(1);
+    alignas(16) int32_t sums[4];
+    for (int j = 0; j < outputs; j++) {
+        const int8_t* row = weights + static_cast<size_t>(j) * stride;
+        size_t n = 0;
+
+        // One-block rows: both halves of the weight row stay in registers
+        if (stride == BLOCK) {
+            const __m128i w0 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row));
+            const __m128i w1 = _mm_loadu_si128(reinterpret_cast<const __m128i*>(row + 16));
+            for (; n + 4 <= batch; n += 4) {
+                const uint8_t* x = inputs + n * BLOCK;
+                __m128i s = _mm_hadd_epi32(
+                    _mm_hadd_epi32(dotSsse3(x, w0, w1, ones), dotSsse3(x + BLOCK, w0, w1, ones)),
+                    _mm_hadd_epi32(dotSsse3(x + 2 * BLOCK, w0, w1, ones), dotSsse3(x + 3 * BLOCK, w0, w1, ones)));
+                _mm_store_si128(reinterpret_cast<__m128i*>(sums), _mm_add_epi32(s, _mm_set1_epi32(bias[j])));
+                for (int k = 0; k < 4; k++) {
+                    accumulators[(n + k) * outputs + j] = sums[k];
+                }
+            }
+        }
+
+        for (; n < batch; n++) {
+            __m128i sum = dotSsse3(inputs + n * stride, row, stride, ones);
+            sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0x4E));
+            sum = _mm_add_epi32(sum, _mm_shuffle_epi32(sum, 0xB1));
+            accumulators[n * outputs + j] = bias[j] + _mm_cvtsi128_si32(sum);
+        }
+    }
+}
+
+#endif
+
+uint8_t quantize(float value) {
+    if (!(value > 0.0f)) return 0;  // Also catches NaN
+    return static_cast<uint8_t>(std::min(std::lround(value), static_cast<long>(ACTIVATION_MAX)));
+}
+
+template <typename T>
+bool readValues(std::ifstream& in, T* values, size_t count) {
+    return static_cast<bool>(in.read(reinterpret_cast<char*>(values), sizeof(T) * count));
+}
+
+// Per-thread activation and accumulator buffers, grown to the largest batch seen
+struct Scratch {
+    std::vector<uint8_t> activations[2];
+    std::vector<int32_t> accumulators;
+};
+
+} // namespace
+
+NeuralEvaluator::NeuralEvaluator() : inputScale{}, kernel(layerScalar), kernelName("scalar") {
+#ifdef BLOCKDROP_X86_KERNELS
+    if (__builtin_cpu_supports("avx2")) {
+        kernel = layerAvx2;
+        kernelName = "avx2";
+    } else if (__builtin_cpu_supports("ssse3")) {
+        kernel = layerSsse3;
+        kernelName = "ssse3";
+    }
+#endif
+}
+
+bool NeuralEvaluator::load(const std::string& path) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        std::cerr << "Could not open model " << path << std::endl;
+        return false;
+    }
+
+    char magic[4];
+    uint32_t header[3];  // version, inputCount, layerCount
+    if (!readValues(in, magic, 4) || std::memcmp(magic, "BDNN", 4) != 0 ||
+        !readValues(in, header, 3) || header[0] != MODEL_VERSION) {
+        std::cerr << path << " is not a version " << MODEL_VERSION << " model" << std::endl;
+        return false;
+    }
+    if (header[1] != BlockDropGame::FEATURE_COUNT || header[2] == 0 || header[2] > MAX_LAYERS) {
+        std::cerr << path << ": expected " << BlockDropGame::FEATURE_COUNT << " inputs and 1-"
+                  << MAX_LAYERS << " layers" << std::endl;
+        return false;
+    }
+
+    std::array<float, BlockDropGame::FEATURE_COUNT> scales;
+    if (!readValues(in, scales.data(), scales.size())) {
+        std::cerr << path << ": truncated input scales" << std::endl;
+        return false;
+    }
+
+    std::vector<Layer> loaded(header[2]);
+    int inputs = BlockDropGame::FEATURE_COUNT;
+    for (size_t l = 0; l < loaded.size(); l++) {
+        Layer& layer = loaded[l];
+        uint32_t outputs;
+        if (!readValues(in, &outputs, 1) || outputs == 0 || outputs > MAX_WIDTH ||
+            (l + 1 == loaded.size() && outputs != 1)) {
+            std::cerr << path << ": layer " << l << " has an invalid width" << std::endl;
+            return false;
+        }
+        layer.inputs = inputs;
+        layer.outputs = outputs;
+        layer.stride = (inputs + BLOCK - 1) / BLOCK * BLOCK;
+        layer.bias.resize(outputs);
+        layer.weights.assign(static_cast<size_t>(outputs) * layer.stride, 0);
+
+        bool ok = readValues(in, &layer.scale, 1) && readValues(in, layer.bias.data(), outputs);
+        for (uint32_t j = 0; ok && j < outputs; j++) {
+            ok = readValues(in, layer.weights.data() + static_cast<size_t>(j) * layer.stride, inputs);
+        }
+        if (!ok) {
+            std::cerr << path << ": truncated layer " << l << std::endl;
+            return false;
+        }
+        inputs = outputs;
+    }
+
+    inputScale = scales;
+    layers = std::move(loaded);
+    return true;
+}
+
+void NeuralEvaluator::scoreMoves(BlockDropGame::MoveCandidate* candidates, size_t count) const {
+    if (layers.empty() || count == 0) return;
+
+    thread_local Scratch scratch;
+    auto* input = &scratch.activations[0];
+    auto* output = &scratch.activations[1];
+
+    // Quantize the features of every candidate into one row each
+    const int inputStride = layers.front().stride;
+    input->assign(count * inputStride, 0);
+    for (size_t n = 0; n < count; n++) {
+        const auto& f = candidates[n].features;
+        const int values[BlockDropGame::FEATURE_COUNT] = {
+            f.maxHeight, f.aggregateHeight, f.completeLines, f.holes,
+            f.bumpiness, f.totalTiles, f.nearlyCompleteRows, f.emptyColumns
+        };
+        uint8_t* row = input->data() + n * inputStride;
+        for (int i = 0; i < BlockDropGame::FEATURE_COUNT; i++) {
+            row[i] = quantize(values[i] * inputScale[i]);
+        }
+    }
+
+    for (size_t l = 0; l < layers.size(); l++) {
+        const Layer& layer = layers[l];
+        scratch.accumulators.resize(count * layer.outputs);
+        kernel(input->data(), count, layer.stride, layer.weights.data(), layer.bias.data(),
+               layer.outputs, scratch.accumulators.data());
+
+        if (l + 1 == layers.size()) {
+            for (size_t n = 0; n < count; n++) {
+                candidates[n].score = scratch.accumulators[n] * static_cast<double>(layer.scale);
+            }
+            break;
+        }
+
+        // Clipped ReLU into the next layer's padded rows
+        const int nextStride = layers[l + 1].stride;
+        output->assign(count * nextStride, 0);
+        for (size_t n = 0; n < count; n++) {
+            const int32_t* acc = scratch.accumulators.data() + n * layer.outputs;
+            uint8_t* row = output->data() + n * nextStride;
+            for (int j = 0; j < layer.outputs; j++) {
+                row[j] = quantize(acc[j] * layer.scale);
+            }
+        }
+        std::swap(input, output);
+    }
+}
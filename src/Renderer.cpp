@@ -1,101 +1,52 @@
 #include "Renderer.h"
 #include "BlockDropGame.h"
-#include <iostream>
+#include "GameGrid.h"
+#include "SdlBackend.h"
+#include <algorithm>
+#include <cstdio>
+#include <iterator>
 
-Renderer::Renderer() : window(nullptr), renderer(nullptr), font(nullptr) {}
+Renderer::Renderer()
+    : backend(std::make_unique<SdlBackend>(WINDOW_WIDTH, WINDOW_HEIGHT)) {}
 
-Renderer::~Renderer() {
-    cleanup();
-}
+Renderer::Renderer(std::unique_ptr<RenderBackend> backend) : backend(std::move(backend)) {}
 
 bool Renderer::initialize() {
-    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
-        std::cerr << "SDL could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
-        return false;
-    }
-    
-    if (TTF_Init() == -1) {
-        std::cerr << "SDL_ttf could not initialize! TTF_Error: " << TTF_GetError() << std::endl;
+    if (!backend->initialize()) {
         return false;
     }
-    
-    window = SDL_CreateWindow("BlockDrop",
-                             SDL_WINDOWPOS_UNDEFINED,
-                             SDL_WINDOWPOS_UNDEFINED,
-                             WINDOW_WIDTH,
-                             WINDOW_HEIGHT,
-                             SDL_WINDOW_SHOWN);
-    
-    if (!window) {
-        std::cerr << "Window could not be created! SDL_Error: " << SDL_GetError() << std::endl;
-        return false;
-    }
-    
-    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
-    if (!renderer) {
-        std::cerr << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
-        return false;
-    }
-    
-    // Try to load a system font, fallback to a simple implementation if not found
-    font = TTF_OpenFont("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", 16);
-    if (!font) {
-        font = TTF_OpenFont("/System/Library/Fonts/Arial.ttf", 16);
-    }
-    if (!font) {
-        font = TTF_OpenFont("/Windows/Fonts/arial.ttf", 16);
-    }
-    if (!font) {
-        std::cerr << "Warning: Could not load font! TTF_Error: " << TTF_GetError() << std::endl;
-        std::cerr << "Text will be displayed as simple rectangles." << std::endl;
-    }
-    
+
+    Color palette[TILE_COUNT];
+    std::copy(std::begin(colors), std::end(colors), palette);
+    palette[TILE_BOARD_BACKGROUND] = {32, 32, 32, 255};
+    palette[TILE_BOARD_BORDER] = {255, 255, 255, 255};
+    palette[TILE_GAME_OVER_BORDER] = {255, 0, 0, 255};
+    backend->setTilePalette(palette, TILE_COUNT);
     return true;
 }
 
 void Renderer::cleanup() {
-    if (font) {
-        TTF_CloseFont(font);
-        font = nullptr;
-    }
-    
-    if (renderer) {
-        SDL_DestroyRenderer(renderer);
-        renderer = nullptr;
-    }
-    
-    if (window) {
-        SDL_DestroyWindow(window);
-        window = nullptr;
-    }
-    
-    TTF_Quit();
-    SDL_Quit();
+    backend->cleanup();
 }
 
 void Renderer::clear() {
-    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
-    SDL_RenderClear(renderer);
+    backend->clear();
 }
 
 void Renderer::present() {
-    SDL_RenderPresent(renderer);
+    backend->present();
 }
 
-void Renderer::setColor(const SDL_Color& color) {
-    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+void Renderer::setColor(const Color& color) {
+    backend->setColor(color);
 }
 
 void Renderer::drawRect(int x, int y, int width, int height, bool filled) {
-    SDL_Rect rect = {x, y, width, height};
-    if (filled) {
-        SDL_RenderFillRect(renderer, &rect);
-    } else {
-        SDL_RenderDrawRect(renderer, &rect);
-    }
+    backend->drawRect(x, y, width, height, filled);
 }
 
-void Renderer::drawGame(const BlockDropGame& game) {
+template <int Width, int Height>
+void Renderer::drawGame(const BasicBlockDropGame<Width, Height>& game) {
     clear();
     
     drawBoard(game);
@@ -105,70 +56,146 @@ void Renderer::drawGame(const BlockDropGame& game) {
     present();
 }
 
-void Renderer::drawBoard(const BlockDropGame& game) {
+void Renderer::drawGrid(GameGrid& grid) {
+    const int count = grid.size();
+    const int boardWidth = BlockDropGame::BOARD_WIDTH;
+    const int boardHeight = BlockDropGame::BOARD_HEIGHT;
+    const int areaWidth = WINDOW_WIDTH - GRID_GAP;
+    const int areaHeight = WINDOW_HEIGHT - GRID_HEADER_HEIGHT - GRID_GAP;
+
+    // Pick the column count that gives the largest cells
+    int columns = 1;
+    int cellSize = 0;
+    for (int c = 1; c <= count; c++) {
+        int rows = (count + c - 1) / c;
+        int sizeX = (areaWidth / c - GRID_GAP - 2) / boardWidth;
+        int sizeY = (areaHeight / rows - GRID_GAP - 2) / boardHeight;
+        int size = std::min(sizeX, sizeY);
+        if (size > cellSize) {
+            cellSize = size;
+            columns = c;
+        }
+    }
+    cellSize = std::max(cellSize, 1);
+    const int pitchX = areaWidth / columns;
+    const int pitchY = areaHeight / ((count + columns - 1) / columns);
+    // Leave a one pixel gap between cells once they are big enough to show it
+    const int cellFill = cellSize > 3 ? cellSize - 1 : cellSize;
+
+    gridQuads.clear();
+    int alive = 0;
+    int bestScore = 0;
+
+    for (int i = 0; i < count; i++) {
+        const BoardSnapshot& snapshot = grid.acquireSnapshot(i);
+        int originX = GRID_GAP + (i % columns) * pitchX + 1;
+        int originY = GRID_HEADER_HEIGHT + GRID_GAP + (i / columns) * pitchY + 1;
+
+        // Border first, board background drawn over its interior
+        gridQuads.push_back({originX - 1, originY - 1,
+                             boardWidth * cellSize + 2, boardHeight * cellSize + 2,
+                             snapshot.gameOver ? TILE_GAME_OVER_BORDER : TILE_BOARD_BORDER});
+        gridQuads.push_back({originX, originY, boardWidth * cellSize, boardHeight * cellSize,
+                             TILE_BOARD_BACKGROUND});
+
+        for (int y = 0; y < boardHeight; y++) {
+            for (int x = 0; x < boardWidth; x++) {
+                int cellValue = snapshot.cells[y][x];
+                if (cellValue > 0) {
+                    gridQuads.push_back({originX + x * cellSize, originY + y * cellSize,
+                                         cellFill, cellFill, cellValue});
+                }
+            }
+        }
+
+        if (!snapshot.gameOver) alive++;
+        bestScore = std::max(bestScore, snapshot.score);
+    }
+
+    clear();
+    backend->drawTiles(gridQuads.data(), static_cast<int>(gridQuads.size()));
+
+    char text[64];
+    std::snprintf(text, sizeof(text), "Boards: %d  Running: %d  Best: %d", count, alive, bestScore);
+    setColor({255, 255, 255, 255});
+    drawText(text, GRID_GAP, GRID_GAP);
+
+    present();
+}
+
+template <int Width, int Height>
+void Renderer::drawBoard(const BasicBlockDropGame<Width, Height>& game) {
     const auto& board = game.getBoard();
+    const int cell = cellSize<Width, Height>();
     
     // Draw board background
     setColor({32, 32, 32, 255});
     drawRect(BOARD_OFFSET_X - 2, BOARD_OFFSET_Y - 2, 
-             BlockDropGame::BOARD_WIDTH * CELL_SIZE + 4, 
-             BlockDropGame::BOARD_HEIGHT * CELL_SIZE + 4);
+             Width * cell + 4, 
+             Height * cell + 4);
     
     // Draw board border
     setColor({255, 255, 255, 255});
     drawRect(BOARD_OFFSET_X - 2, BOARD_OFFSET_Y - 2, 
-             BlockDropGame::BOARD_WIDTH * CELL_SIZE + 4, 
-             BlockDropGame::BOARD_HEIGHT * CELL_SIZE + 4, false);
+             Width * cell + 4, 
+             Height * cell + 4, false);
     
     // Draw board cells
-    for (int y = 0; y < BlockDropGame::BOARD_HEIGHT; y++) {
-        for (int x = 0; x < BlockDropGame::BOARD_WIDTH; x++) {
+    for (int y = 0; y < Height; y++) {
+        for (int x = 0; x < Width; x++) {
             int cellValue = board[y][x];
             if (cellValue > 0) {
                 setColor(colors[cellValue]);
-                drawRect(BOARD_OFFSET_X + x * CELL_SIZE,
-                        BOARD_OFFSET_Y + y * CELL_SIZE,
-                        CELL_SIZE - 1, CELL_SIZE - 1);
+                drawRect(BOARD_OFFSET_X + x * cell,
+                        BOARD_OFFSET_Y + y * cell,
+                        cell - 1, cell - 1);
             }
         }
     }
 }
 
-void Renderer::drawCurrentPiece(const BlockDropGame& game) {
+template <int Width, int Height>
+void Renderer::drawCurrentPiece(const BasicBlockDropGame<Width, Height>& game) {
     if (game.isGameOver()) return;
     
     const auto& pieceShape = game.getCurrentPieceShape();
     int pieceType = static_cast<int>(game.getCurrentPieceType()) + 1; // +1 because colors[0] is for empty cells
+    const int cell = cellSize<Width, Height>();
     
     setColor(colors[pieceType]);
     
-    for (int y = 0; y < BlockDropGame::PIECE_SIZE; y++) {
-        for (int x = 0; x < BlockDropGame::PIECE_SIZE; x++) {
+    for (int y = 0; y < BlockDropRules::PIECE_SIZE; y++) {
+        for (int x = 0; x < BlockDropRules::PIECE_SIZE; x++) {
             if (pieceShape[y][x] == '#') {
-                int screenX = BOARD_OFFSET_X + (game.getCurrentX() + x) * CELL_SIZE;
-                int screenY = BOARD_OFFSET_Y + (game.getCurrentY() + y) * CELL_SIZE;
+                int screenX = BOARD_OFFSET_X + (game.getCurrentX() + x) * cell;
+                int screenY = BOARD_OFFSET_Y + (game.getCurrentY() + y) * cell;
                 
                 if (screenX >= BOARD_OFFSET_X && 
-                    screenX < BOARD_OFFSET_X + BlockDropGame::BOARD_WIDTH * CELL_SIZE &&
+                    screenX < BOARD_OFFSET_X + Width * cell &&
                     screenY >= BOARD_OFFSET_Y && 
-                    screenY < BOARD_OFFSET_Y + BlockDropGame::BOARD_HEIGHT * CELL_SIZE) {
-                    drawRect(screenX, screenY, CELL_SIZE - 1, CELL_SIZE - 1);
+                    screenY < BOARD_OFFSET_Y + Height * cell) {
+                    drawRect(screenX, screenY, cell - 1, cell - 1);
                 }
             }
         }
     }
 }
 
-void Renderer::drawUI(const BlockDropGame& game) {
-    int infoX = BOARD_OFFSET_X + BlockDropGame::BOARD_WIDTH * CELL_SIZE + 20;
+template <int Width, int Height>
+void Renderer::drawUI(const BasicBlockDropGame<Width, Height>& game) {
+    int infoX = BOARD_OFFSET_X + Width * cellSize<Width, Height>() + HUD_GAP;
     int infoY = BOARD_OFFSET_Y;
     
     setColor({255, 255, 255, 255});
     
     // Draw score, level, lines
-    drawText("Score: " + std::to_string(game.getScore()), infoX, infoY);
-    drawText("Level: " + std::to_string(game.getLevel()), infoX, infoY + 30);
-    drawText("Lines: " + std::to_string(game.getLinesCleared()), infoX, infoY + 60);
+    char text[32];
+    std::snprintf(text, sizeof(text), "Score: %d", game.getScore());
+    drawText(text, infoX, infoY);
+    std::snprintf(text, sizeof(text), "Level: %d", game.getLevel());
+    drawText(text, infoX, infoY + 30);
+    std::snprintf(text, sizeof(text), "Lines: %d", game.getLinesCleared());
+    drawText(text, infoX, infoY + 60);
     
     // Draw controls
     drawText("Controls:", infoX, infoY + 120);
@@ -177,11 +204,12 @@ void Renderer::drawUI(const BlockDropGame& game) {
     drawText("W - Rotate", infoX, infoY + 210);
     drawText("Space - Hard drop", infoX, infoY + 240);
     drawText("T - Toggle auto-play", infoX, infoY + 270);
-    drawText("Q - Quit", infoX, infoY + 300);
+    drawText("U - Undo", infoX, infoY + 300);
+    drawText("K - Save checkpoint", infoX, infoY + 330);
+    drawText("Q - Quit", infoX, infoY + 360);
     
     // Auto-play status
-    std::string autoStatus = "Auto-play: " + std::string(game.isAutoPlay() ? "ON" : "OFF");
-    drawText(autoStatus, infoX, infoY + 330);
+    drawText(game.isAutoPlay() ? "Auto-play: ON" : "Auto-play: OFF", infoX, infoY + 390);
     
     // Game over message
     if (game.isGameOver()) {
@@ -191,32 +219,10 @@ void Renderer::drawUI(const BlockDropGame& game) {
     }
 }
 
-void Renderer::drawText(const std::string& text, int x, int y) {
-    if (font) {
-        // Use SDL_ttf for proper text rendering
-        SDL_Color color = {255, 255, 255, 255}; // White text
-        SDL_Surface* textSurface = TTF_RenderText_Solid(font, text.c_str(), color);
-        if (textSurface) {
-            SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
-            if (textTexture) {
-                SDL_Rect destRect = {x, y, textSurface->w, textSurface->h};
-                SDL_RenderCopy(renderer, textTexture, nullptr, &destRect);
-                SDL_DestroyTexture(textTexture);
-            }
-            SDL_FreeSurface(textSurface);
-        }
-    } else {
-        // Fallback: Simple text rendering using rectangles for characters
-        const int charWidth = 8;
-        const int charHeight = 12;
-        
-        setColor({255, 255, 255, 255}); // White color
-        for (size_t i = 0; i < text.length(); i++) {
-            char c = text[i];
-            if (c >= 32 && c <= 126) { // Printable ASCII
-                // Draw a simple rectangle for each character
-                drawRect(x + i * charWidth, y, charWidth - 1, charHeight, false);
-            }
-        }
-    }
-}
\ No newline at end of file
+void Renderer::drawText(const char* text, int x, int y) {
+    backend->drawText(text, x, y);
+}
+
+#define BLOCKDROP_INSTANTIATE_RENDERER(width, height) \
+    template void Renderer::drawGame(const BasicBlockDropGame<width, height>& game);
+BLOCKDROP_GEOMETRIES(BLOCKDROP_INSTANTIATE_RENDERER)
@@ -0,0 +1,29 @@
+#include "RollbackRing.h"
+
+RollbackRing::RollbackRing(size_t depth)
+    : states(depth > 0 ? depth : 1), head(0), count(0) {}
+
+void RollbackRing::push(const BlockDropGame& game) {
+    game.saveState(states[head]);
+    head = (head + 1) % states.size();
+    if (count < states.size()) {
+        count++;
+    }
+}
+
+bool RollbackRing::undo(BlockDropGame& game) {
+    if (count == 0) {
+        return false;
+    }
+    head = (head + states.size() - 1) % states.size();
+    count--;
+    game.restoreState(states[head]);
+    return true;
+}
+
+const BlockDropGame::State* RollbackRing::peek(size_t stepsBack) const {
+    if (stepsBack >= count) {
+        return nullptr;
+    }
+    return &states[(head + states.size() - 1 - stepsBack) % states.size()];
+}
@@ -0,0 +1,218 @@
+#include "SdlBackend.h"
+#include <cstring>
+#include <iostream>
+
+namespace {
+
+// Edge length of one atlas tile in texels. Quads sample only the inner texels
+// so linear filtering never bleeds a neighbouring tile's color.
+const int ATLAS_TILE_SIZE = 4;
+
+} // namespace
+
+SdlBackend::SdlBackend(int width, int height)
+    : window(nullptr), renderer(nullptr), font(nullptr)
+    , atlas(nullptr), atlasTiles(0)
+    , width(width), height(height) {}
+
+SdlBackend::~SdlBackend() {
+    cleanup();
+}
+
+bool SdlBackend::initialize() {
+    if (SDL_Init(SDL_INIT_VIDEO) < 0) {
+        std::cerr << "SDL could not initialize! SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    if (TTF_Init() == -1) {
+        std::cerr << "SDL_ttf could not initialize! TTF_Error: " << TTF_GetError() << std::endl;
+        return false;
+    }
+
+    window = SDL_CreateWindow("BlockDrop",
+                             SDL_WINDOWPOS_UNDEFINED,
+                             SDL_WINDOWPOS_UNDEFINED,
+                             width,
+                             height,
+                             SDL_WINDOW_SHOWN);
+
+    if (!window) {
+        std::cerr << "Window could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    renderer = SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED);
+    if (!renderer) {
+        std::cerr << "Renderer could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+        return false;
+    }
+
+    // Try to load a system font, fallback to a simple implementation if not found
+    font = TTF_OpenFont("/usr/share/fonts/truetype/dejavu/DejaVuSans.ttf", 16);
+    if (!font) {
+        font = TTF_OpenFont("/System/Library/Fonts/Arial.ttf", 16);
+    }
+    if (!font) {
+        font = TTF_OpenFont("/Windows/Fonts/arial.ttf", 16);
+    }
+    if (!font) {
+        std::cerr << "Warning: Could not load font! TTF_Error: " << TTF_GetError() << std::endl;
+        std::cerr << "Text will be displayed as simple rectangles." << std::endl;
+    }
+
+    return true;
+}
+
+void SdlBackend::cleanup() {
+    if (atlas) {
+        SDL_DestroyTexture(atlas);
+        atlas = nullptr;
+    }
+
+    if (font) {
+        TTF_CloseFont(font);
+        font = nullptr;
+    }
+
+    if (renderer) {
+        SDL_DestroyRenderer(renderer);
+        renderer = nullptr;
+    }
+
+    if (window) {
+        SDL_DestroyWindow(window);
+        window = nullptr;
+    }
+
+    TTF_Quit();
+    SDL_Quit();
+}
+
+void SdlBackend::clear() {
+    SDL_SetRenderDrawColor(renderer, 0, 0, 0, 255);
+    SDL_RenderClear(renderer);
+}
+
+void SdlBackend::present() {
+    SDL_RenderPresent(renderer);
+}
+
+void SdlBackend::setColor(const Color& color) {
+    SDL_SetRenderDrawColor(renderer, color.r, color.g, color.b, color.a);
+}
+
+void SdlBackend::drawRect(int x, int y, int width, int height, bool filled) {
+    SDL_Rect rect = {x, y, width, height};
+    if (filled) {
+        SDL_RenderFillRect(renderer, &rect);
+    } else {
+        SDL_RenderDrawRect(renderer, &rect);
+    }
+}
+
+void SdlBackend::drawText(const char* text, int x, int y) {
+    if (font) {
+        // Use SDL_ttf for proper text rendering
+        SDL_Color color = {255, 255, 255, 255}; // White text
+        SDL_Surface* textSurface = TTF_RenderText_Solid(font, text, color);
+        if (textSurface) {
+            SDL_Texture* textTexture = SDL_CreateTextureFromSurface(renderer, textSurface);
+            if (textTexture) {
+                SDL_Rect destRect = {x, y, textSurface->w, textSurface->h};
+                SDL_RenderCopy(renderer, textTexture, nullptr, &destRect);
+                SDL_DestroyTexture(textTexture);
+            }
+            SDL_FreeSurface(textSurface);
+        }
+    } else {
+        // Fallback: Simple text rendering using rectangles for characters
+        const int charWidth = 8;
+        const int charHeight = 12;
+
+        setColor({255, 255, 255, 255}); // White color
+        size_t length = std::strlen(text);
+        for (size_t i = 0; i < length; i++) {
+            char c = text[i];
+            if (c >= 32 && c <= 126) { // Printable ASCII
+                // Draw a simple rectangle for each character
+                drawRect(x + i * charWidth, y, charWidth - 1, charHeight, false);
+            }
+        }
+    }
+}
+
+void SdlBackend::setTilePalette(const Color* colors, int count) {
+    if (atlas) {
+        SDL_DestroyTexture(atlas);
+        atlas = nullptr;
+    }
+
+    atlas = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA32, SDL_TEXTUREACCESS_STATIC,
+                              count * ATLAS_TILE_SIZE, ATLAS_TILE_SIZE);
+    if (!atlas) {
+        std::cerr << "Tile atlas could not be created! SDL_Error: " << SDL_GetError() << std::endl;
+        atlasTiles = 0;
+        return;
+    }
+
+    int pitch = count * ATLAS_TILE_SIZE * 4;
+    std::vector<Uint8> texels(static_cast<size_t>(pitch) * ATLAS_TILE_SIZE);
+    for (int y = 0; y < ATLAS_TILE_SIZE; y++) {
+        for (int x = 0; x < count * ATLAS_TILE_SIZE; x++) {
+            const Color& color = colors[x / ATLAS_TILE_SIZE];
+            Uint8* texel = &texels[y * pitch + x * 4];
+            texel[0] = color.r;
+            texel[1] = color.g;
+            texel[2] = color.b;
+            texel[3] = color.a;
+        }
+    }
+    SDL_UpdateTexture(atlas, nullptr, texels.data(), pitch);
+    atlasTiles = count;
+}
+
+void SdlBackend::drawTiles(const TileQuad* quads, int count) {
+    if (!atlas || count <= 0) return;
+
+    // The index pattern only depends on the quad count, so it is built once per capacity
+    if (indices.size() < static_cast<size_t>(count) * 6) {
+        size_t oldQuads = indices.size() / 6;
+        indices.resize(static_cast<size_t>(count) * 6);
+        for (size_t q = oldQuads; q < static_cast<size_t>(count); q++) {
+            int base = static_cast<int>(q * 4);
+            int* index = &indices[q * 6];
+            index[0] = base;
+            index[1] = base + 1;
+            index[2] = base + 2;
+            index[3] = base;
+            index[4] = base + 2;
+            index[5] = base + 3;
+        }
+    }
+    vertices.resize(static_cast<size_t>(count) * 4);
+
+    const float tileWidth = 1.0f / atlasTiles;
+    const float inset = tileWidth / ATLAS_TILE_SIZE;
+    const float v0 = 1.0f / ATLAS_TILE_SIZE;
+    const float v1 = 1.0f - v0;
+    const SDL_Color white = {255, 255, 255, 255};
+
+    for (int i = 0; i < count; i++) {
+        const TileQuad& quad = quads[i];
+        float x0 = static_cast<float>(quad.x);
+        float y0 = static_cast<float>(quad.y);
+        float x1 = x0 + quad.width;
+        float y1 = y0 + quad.height;
+        float u0 = quad.tile * tileWidth + inset;
+        float u1 = (quad.tile + 1) * tileWidth - inset;
+
+        SDL_Vertex* vertex = &vertices[static_cast<size_t>(i) * 4];
+        vertex[0] = {{x0, y0}, white, {u0, v0}};
+        vertex[1] = {{x1, y0}, white, {u1, v0}};
+        vertex[2] = {{x1, y1}, white, {u1, v1}};
+        vertex[3] = {{x0, y1}, white, {u0, v1}};
+    }
+
+    SDL_RenderGeometry(renderer, atlas, vertices.data(), count * 4, indices.data(), count * 6);
+}
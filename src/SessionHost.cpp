@@ -0,0 +1,412 @@
+#include "SessionHost.h"
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+
+namespace {
+
+void reportRow(std::ostream& out, const char* name, const LatencyHistogram& samples) {
+    if (samples.count() == 0) return;
+
+    out << std::left << std::setw(14) << name << std::right << std::fixed << std::setprecision(3)
+        << std::setw(8) << samples.percentile(0.50)
+        << std::setw(8) << samples.percentile(0.90)
+        << std::setw(8) << samples.percentile(0.99)
+        << std::setw(8) << samples.max() << "\n";
+}
+
+} // namespace
+
+SessionHost::InputQueue::InputQueue(uint32_t size)
+    : cells(new Cell[size]), mask(size - 1), tail(0), head(0)
+{
+    for (uint32_t i = 0; i < size; i++) {
+        cells[i].sequence.store(i, std::memory_order_relaxed);
+    }
+}
+
+bool SessionHost::InputQueue::push(const Input& input) {
+    uint32_t position = tail.load(std::memory_order_relaxed);
+    for (;;) {
+        Cell& cell = cells[position & mask];
+        uint32_t sequence = cell.sequence.load(std::memory_order_acquire);
+        int32_t lag = static_cast<int32_t>(sequence - position);
+        if (lag == 0) {
+            // The cell is free for this position; claim it
+            if (tail.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                cell.input = input;
+                cell.sequence.store(position + 1, std::memory_order_release);
+                return true;
+            }
+        } else if (lag < 0) {
+            return false;  // The consumer has not read this cell yet: full
+        } else {
+            position = tail.load(std::memory_order_relaxed);  // Another producer got there first
+        }
+    }
+}
+
+bool SessionHost::InputQueue::pop(Input& out) {
+    Cell& cell = cells[head & mask];
+    if (cell.sequence.load(std::memory_order_acquire) != head + 1) {
+        return false;
+    }
+    out = cell.input;
+    cell.sequence.store(head + mask + 1, std::memory_order_release);
+    head++;
+    return true;
+}
+
+SessionHost::Shard::Shard(size_t capacity)
+    : piecesPlaced(0), inputs(INPUT_QUEUE_SIZE)
+{
+    fallTime.reserve(capacity);
+    fallInterval.reserve(capacity);
+    rows.reserve(capacity);
+    piece.reserve(capacity);
+    rotation.reserve(capacity);
+    x.reserve(capacity);
+    y.reserve(capacity);
+    rng.reserve(capacity);
+    score.reserve(capacity);
+    lines.reserve(capacity);
+    level.reserve(capacity);
+    flags.reserve(capacity);
+    owner.reserve(capacity);
+    cells.reserve(capacity);
+    due.resize(capacity);
+}
+
+SessionHost::SessionHost(uint32_t capacity, int shardCount)
+    : generations(capacity, 0), slotOf(capacity, NO_SLOT),
+      tickNumber(0), workersBusy(0), tickDelta(0.0f), running(false)
+{
+    shardCount = std::max(1, std::min(shardCount, static_cast<int>(std::max(capacity, 1u))));
+    size_t perShard = (capacity + shardCount - 1) / shardCount;
+    for (int s = 0; s < shardCount; s++) {
+        shards.push_back(std::make_unique<Shard>(perShard));
+    }
+
+    freeIndices.reserve(capacity);
+    for (uint32_t i = capacity; i > 0; i--) {
+        freeIndices.push_back(i - 1);
+    }
+}
+
+SessionHost::~SessionHost() {
+    stop();
+}
+
+void SessionHost::start(int threadCount) {
+    if (!workers.empty()) return;
+
+    threadCount = std::max(1, std::min(threadCount, static_cast<int>(shards.size())));
+    running = true;
+    for (int t = 0; t < threadCount; t++) {
+        workers.emplace_back(&SessionHost::workerLoop, this, t, threadCount);
+    }
+}
+
+void SessionHost::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        running = false;
+    }
+    tickStarted.notify_all();
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    workers.clear();
+}
+
+bool SessionHost::isLive(SessionHandle handle) const {
+    return handle.index < slotOf.size() && slotOf[handle.index] != NO_SLOT &&
+           generations[handle.index] == handle.generation;
+}
+
+bool SessionHost::create(uint64_t seed, bool bot, SessionHandle& out) {
+    if (freeIndices.empty()) return false;
+
+    uint32_t index = freeIndices.back();
+    freeIndices.pop_back();
+    Shard& shard = shardOf(index);
+    uint32_t slot = static_cast<uint32_t>(shard.owner.size());
+    slotOf[index] = slot;
+
+    shard.fallTime.push_back(0.0f);
+    shard.fallInterval.push_back(bot ? BOT_FALL_INTERVAL : static_cast<float>(Game::fallSpeedForLevel(1)));
+    shard.rows.emplace_back();
+    shard.rows.back().fill(0);
+    shard.piece.push_back(0);
+    shard.rotation.push_back(0);
+    shard.x.push_back(0);
+    shard.y.push_back(0);
+    shard.rng.push_back(seed ? seed : 0x9E3779B97F4A7C15ull);  // xorshift must not start at zero
+    shard.score.push_back(0);
+    shard.lines.push_back(0);
+    shard.level.push_back(1);
+    shard.flags.push_back(bot ? BOT : 0);
+    shard.owner.push_back(index);
+    shard.cells.emplace_back();
+    for (auto& row : shard.cells.back()) {
+        row.fill(0);
+    }
+
+    out = {index, generations[index]};
+    spawn(shard, slot);
+    return true;
+}
+
+bool SessionHost::destroy(SessionHandle handle) {
+    if (!isLive(handle)) return false;
+
+    Shard& shard = shardOf(handle.index);
+    uint32_t slot = slotOf[handle.index];
+    uint32_t last = static_cast<uint32_t>(shard.owner.size()) - 1;
+
+    // Move the shard's last session into the hole
+    auto removeAt = [slot](auto& column) {
+        column[slot] = column.back();
+        column.pop_back();
+    };
+    removeAt(shard.fallTime);
+    removeAt(shard.fallInterval);
+    removeAt(shard.rows);
+    removeAt(shard.piece);
+    removeAt(shard.rotation);
+    removeAt(shard.x);
+    removeAt(shard.y);
+    removeAt(shard.rng);
+    removeAt(shard.score);
+    removeAt(shard.lines);
+    removeAt(shard.level);
+    removeAt(shard.flags);
+    removeAt(shard.owner);
+    removeAt(shard.cells);
+    if (slot != last) {
+        slotOf[shard.owner[slot]] = slot;
+    }
+
+    slotOf[handle.index] = NO_SLOT;
+    generations[handle.index]++;
+    freeIndices.push_back(handle.index);
+    return true;
+}
+
+bool SessionHost::getSession(SessionHandle handle, SessionView& out) const {
+    if (!isLive(handle)) return false;
+
+    const Shard& shard = shardOf(handle.index);
+    uint32_t slot = slotOf[handle.index];
+    out.board = shard.cells[slot];
+    out.piece = static_cast<Game::TetrominoType>(shard.piece[slot]);
+    out.x = shard.x[slot];
+    out.y = shard.y[slot];
+    out.rotation = shard.rotation[slot];
+    out.score = shard.score[slot];
+    out.level = shard.level[slot];
+    out.linesCleared = shard.lines[slot];
+    out.bot = (shard.flags[slot] & BOT) != 0;
+    out.gameOver = (shard.flags[slot] & FINISHED) != 0;
+    return true;
+}
+
+void SessionHost::takeFinished(std::vector<SessionHandle>& out) {
+    for (auto& shard : shards) {
+        out.insert(out.end(), shard->finished.begin(), shard->finished.end());
+        shard->finished.clear();
+    }
+}
+
+bool SessionHost::submitInput(SessionHandle handle, char key) {
+    if (handle.index >= slotOf.size()) return false;
+    return shardOf(handle.index).inputs.push({handle, key, Clock::now()});
+}
+
+uint64_t SessionHost::getPiecesPlaced() const {
+    uint64_t total = 0;
+    for (const auto& shard : shards) {
+        total += shard->piecesPlaced;
+    }
+    return total;
+}
+
+void SessionHost::tick(double deltaTime) {
+    auto start = Clock::now();
+
+    if (workers.empty()) {
+        for (auto& shard : shards) {
+            tickShard(*shard, static_cast<float>(deltaTime));
+        }
+    } else {
+        std::unique_lock<std::mutex> lock(mutex);
+        tickDelta = static_cast<float>(deltaTime);
+        workersBusy = static_cast<int>(workers.size());
+        tickNumber++;
+        tickStarted.notify_all();
+        tickFinished.wait(lock, [this]() { return workersBusy == 0; });
+    }
+
+    tickTimes.record(std::chrono::duration<double, std::milli>(Clock::now() - start).count());
+}
+
+void SessionHost::workerLoop(int worker, int workerCount) {
+    uint64_t seen = 0;
+    for (;;) {
+        float deltaTime;
+        {
+            std::unique_lock<std::mutex> lock(mutex);
+            tickStarted.wait(lock, [&]() { return !running || tickNumber != seen; });
+            if (!running) return;
+            seen = tickNumber;
+            deltaTime = tickDelta;
+        }
+
+        for (size_t s = worker; s < shards.size(); s += workerCount) {
+            tickShard(*shards[s], deltaTime);
+        }
+
+        std::lock_guard<std::mutex> lock(mutex);
+        if (--workersBusy == 0) {
+            tickFinished.notify_one();
+        }
+    }
+}
+
+void SessionHost::tickShard(Shard& shard, float deltaTime) {
+    // Inputs first, so a key pressed before the tick lands before gravity
+    Input input;
+    while (shard.inputs.pop(input)) {
+        if (!isLive(input.handle)) continue;  // Destroyed after the key was sent
+        applyInput(shard, slotOf[input.handle.index], input.key);
+        shard.inputLatency.record(
+            std::chrono::duration<double, std::milli>(Clock::now() - input.time).count());
+    }
+
+    // Gravity for the whole shard: one pass over the timers, then a branchless
+    // compaction of the sessions whose timer ran out
+    const uint32_t count = static_cast<uint32_t>(shard.owner.size());
+    float* fallTime = shard.fallTime.data();
+    const float* fallInterval = shard.fallInterval.data();
+    for (uint32_t i = 0; i < count; i++) {
+        fallTime[i] += deltaTime;
+    }
+
+    uint32_t* due = shard.due.data();
+    uint32_t dueCount = 0;
+    for (uint32_t i = 0; i < count; i++) {
+        due[dueCount] = i;
+        dueCount += fallTime[i] >= fallInterval[i];
+    }
+
+    for (uint32_t d = 0; d < dueCount; d++) {
+        fallTime[due[d]] = 0.0f;
+        stepDown(shard, due[d]);
+    }
+}
+
+void SessionHost::applyInput(Shard& shard, uint32_t slot, char key) {
+    if (shard.flags[slot] & (BOT | FINISHED)) return;
+
+    auto piece = static_cast<Game::TetrominoType>(shard.piece[slot]);
+    int rotation = shard.rotation[slot];
+    int x = shard.x[slot], y = shard.y[slot];
+    const Game::Rows& rows = shard.rows[slot];
+
+    switch (key) {
+        case 'a': case 'A':
+            if (!Game::collides(rows, piece, rotation, x - 1, y)) shard.x[slot]--;
+            break;
+        case 'd': case 'D':
+            if (!Game::collides(rows, piece, rotation, x + 1, y)) shard.x[slot]++;
+            break;
+        case 's': case 'S':
+            stepDown(shard, slot);
+            break;
+        case 'w': case 'W': {
+            int next = (rotation + 1) % Game::rotationCount(piece);
+            if (!Game::collides(rows, piece, next, x, y)) shard.rotation[slot] = static_cast<uint8_t>(next);
+            break;
+        }
+        case ' ':
+            while (!Game::collides(rows, piece, rotation, x, y + 1)) {
+                y++;
+            }
+            shard.y[slot] = static_cast<int8_t>(y);
+            lockAndSpawn(shard, slot);
+            break;
+    }
+}
+
+void SessionHost::stepDown(Shard& shard, uint32_t slot) {
+    auto piece = static_cast<Game::TetrominoType>(shard.piece[slot]);
+    if (!Game::collides(shard.rows[slot], piece, shard.rotation[slot], shard.x[slot], shard.y[slot] + 1)) {
+        shard.y[slot]++;
+        return;
+    }
+    lockAndSpawn(shard, slot);
+}
+
+void SessionHost::lockAndSpawn(Shard& shard, uint32_t slot) {
+    Game::lockPiece(shard.rows[slot], shard.cells[slot], static_cast<Game::TetrominoType>(shard.piece[slot]),
+                    shard.rotation[slot], shard.x[slot], shard.y[slot]);
+    shard.piecesPlaced++;
+
+    int cleared = Game::clearFullRows(shard.rows[slot], shard.cells[slot]);
+    if (cleared > 0) {
+        shard.score[slot] += Game::lineClearScore(cleared, shard.level[slot]);
+        shard.lines[slot] += cleared;
+        shard.level[slot] = shard.lines[slot] / 10 + 1;
+        if (!(shard.flags[slot] & BOT)) {
+            shard.fallInterval[slot] = static_cast<float>(Game::fallSpeedForLevel(shard.level[slot]));
+        }
+    }
+    spawn(shard, slot);
+}
+
+void SessionHost::spawn(Shard& shard, uint32_t slot) {
+    auto piece = Game::randomPiece(shard.rng[slot]);
+    shard.piece[slot] = static_cast<uint8_t>(piece);
+    shard.rotation[slot] = 0;
+    shard.x[slot] = Game::SPAWN_X;
+    shard.y[slot] = 0;
+
+    if (Game::collides(shard.rows[slot], piece, 0, Game::SPAWN_X, 0)) {
+        shard.flags[slot] |= FINISHED;
+        shard.fallInterval[slot] = INFINITY;  // Never due again
+        uint32_t index = shard.owner[slot];
+        shard.finished.push_back({index, generations[index]});
+        return;
+    }
+
+    // Bots skip the sideways walk of single-game auto-play and start right
+    // above their chosen placement
+    if (shard.flags[slot] & BOT) {
+        Game::searchMoves(shard.rows[slot], piece, evaluator.get(), shard.candidates);
+        if (shard.candidates.empty()) return;
+
+        size_t best = 0;
+        for (size_t i = 1; i < shard.candidates.size(); i++) {
+            if (shard.candidates[i].score > shard.candidates[best].score) {
+                best = i;
+            }
+        }
+        shard.x[slot] = static_cast<int8_t>(shard.candidates[best].x);
+        shard.rotation[slot] = static_cast<uint8_t>(shard.candidates[best].rotation);
+    }
+}
+
+void SessionHost::report(std::ostream& out) const {
+    LatencyHistogram inputs;
+    for (const auto& shard : shards) {
+        inputs.merge(shard->inputLatency);
+    }
+
+    out << "Fleet latency (ms, " << tickTimes.count() << " ticks of " << size() << " sessions on "
+        << shards.size() << " shards, " << inputs.count() << " inputs)\n";
+    out << std::left << std::setw(14) << "stage"
+        << std::right << std::setw(8) << "p50" << std::setw(8) << "p90"
+        << std::setw(8) << "p99" << std::setw(8) << "max" << "\n";
+    reportRow(out, "tick", tickTimes);
+    reportRow(out, "input", inputs);
+}
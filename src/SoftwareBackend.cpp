@@ -0,0 +1,402 @@
+#include "SoftwareBackend.h"
+#include <algorithm>
+#include <array>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace {
+
+// 5x7 bitmap font covering ASCII 32..95; lowercase is folded to uppercase.
+// Each row stores 5 pixels in the low bits, most significant bit leftmost.
+const uint8_t FONT_5X7[64][7] = {
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00},  // ' '
+    {0x04, 0x04, 0x04, 0x04, 0x04, 0x00, 0x04},  // '!'
+    {0x0A, 0x0A, 0x00, 0x00, 0x00, 0x00, 0x00},  // '"'
+    {0x0A, 0x0A, 0x1F, 0x0A, 0x1F, 0x0A, 0x0A},  // '#'
+    {0x04, 0x0F, 0x14, 0x0E, 0x05, 0x1E, 0x04},  // '$'
+    {0x18, 0x19, 0x02, 0x04, 0x08, 0x13, 0x03},  // '%'
+    {0x0C, 0x12, 0x14, 0x08, 0x15, 0x12, 0x0D},  // '&'
+    {0x04, 0x04, 0x00, 0x00, 0x00, 0x00, 0x00},  // '''
+    {0x02, 0x04, 0x08, 0x08, 0x08, 0x04, 0x02},  // '('
+    {0x08, 0x04, 0x02, 0x02, 0x02, 0x04, 0x08},  // ')'
+    {0x00, 0x04, 0x15, 0x0E, 0x15, 0x04, 0x00},  // '*'
+    {0x00, 0x04, 0x04, 0x1F, 0x04, 0x04, 0x00},  // '+'
+    {0x00, 0x00, 0x00, 0x00, 0x0C, 0x04, 0x08},  // ','
+    {0x00, 0x00, 0x00, 0x1F, 0x00, 0x00, 0x00},  // '-'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x0C, 0x0C},  // '.'
+    {0x00, 0x01, 0x02, 0x04, 0x08, 0x10, 0x00},  // '/'
+    {0x0E, 0x11, 0x13, 0x15, 0x19, 0x11, 0x0E},  // '0'
+    {0x04, 0x0C, 0x04, 0x04, 0x04, 0x04, 0x0E},  // '1'
+    {0x0E, 0x11, 0x01, 0x02, 0x04, 0x08, 0x1F},  // '2'
+    {0x1F, 0x02, 0x04, 0x02, 0x01, 0x11, 0x0E},  // '3'
+    {0x02, 0x06, 0x0A, 0x12, 0x1F, 0x02, 0x02},  // '4'
+    {0x1F, 0x10, 0x1E, 0x01, 0x01, 0x11, 0x0E},  // '5'
+    {0x06, 0x08, 0x10, 0x1E, 0x11, 0x11, 0x0E},  // '6'
+    {0x1F, 0x01, 0x02, 0x04, 0x08, 0x08, 0x08},  // '7'
+    {0x0E, 0x11, 0x11, 0x0E, 0x11, 0x11, 0x0E},  // '8'
+    {0x0E, 0x11, 0x11, 0x0F, 0x01, 0x02, 0x0C},  // '9'
+    {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x0C, 0x00},  // ':'
+    {0x00, 0x0C, 0x0C, 0x00, 0x0C, 0x04, 0x08},  // ';'
+    {0x02, 0x04, 0x08, 0x10, 0x08, 0x04, 0x02},  // '<'
+    {0x00, 0x00, 0x1F, 0x00, 0x1F, 0x00, 0x00},  // '='
+    {0x08, 0x04, 0x02, 0x01, 0x02, 0x04, 0x08},  // '>'
+    {0x0E, 0x11, 0x01, 0x02, 0x04, 0x00, 0x04},  // '?'
+    {0x0E, 0x11, 0x17, 0x15, 0x17, 0x10, 0x0E},  // '@'
+    {0x0E, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11},  // 'A'
+    {0x1E, 0x11, 0x11, 0x1E, 0x11, 0x11, 0x1E},  // 'B'
+    {0x0E, 0x11, 0x10, 0x10, 0x10, 0x11, 0x0E},  // 'C'
+    {0x1C, 0x12, 0x11, 0x11, 0x11, 0x12, 0x1C},  // 'D'
+    {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x1F},  // 'E'
+    {0x1F, 0x10, 0x10, 0x1E, 0x10, 0x10, 0x10},  // 'F'
+    {0x0E, 0x11, 0x10, 0x17, 0x11, 0x11, 0x0F},  // 'G'
+    {0x11, 0x11, 0x11, 0x1F, 0x11, 0x11, 0x11},  // 'H'
+    {0x0E, 0x04, 0x04, 0x04, 0x04, 0x04, 0x0E},  // 'I'
+    {0x07, 0x02, 0x02, 0x02, 0x02, 0x12, 0x0C},  // 'J'
+    {0x11, 0x12, 0x14, 0x18, 0x14, 0x12, 0x11},  // 'K'
+    {0x10, 0x10, 0x10, 0x10, 0x10, 0x10, 0x1F},  // 'L'
+    {0x11, 0x1B, 0x15, 0x15, 0x11, 0x11, 0x11},  // 'M'
+    {0x11, 0x11, 0x19, 0x15, 0x13, 0x11, 0x11},  // 'N'
+    {0x0E, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E},  // 'O'
+    {0x1E, 0x11, 0x11, 0x1E, 0x10, 0x10, 0x10},  // 'P'
+    {0x0E, 0x11, 0x11, 0x11, 0x15, 0x12, 0x0D},  // 'Q'
+    {0x1E, 0x11, 0x11, 0x1E, 0x14, 0x12, 0x11},  // 'R'
+    {0x0F, 0x10, 0x10, 0x0E, 0x01, 0x01, 0x1E},  // 'S'
+    {0x1F, 0x04, 0x04, 0x04, 0x04, 0x04, 0x04},  // 'T'
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x11, 0x0E},  // 'U'
+    {0x11, 0x11, 0x11, 0x11, 0x11, 0x0A, 0x04},  // 'V'
+    {0x11, 0x11, 0x11, 0x15, 0x15, 0x15, 0x0A},  // 'W'
+    {0x11, 0x11, 0x0A, 0x04, 0x0A, 0x11, 0x11},  // 'X'
+    {0x11, 0x11, 0x11, 0x0A, 0x04, 0x04, 0x04},  // 'Y'
+    {0x1F, 0x01, 0x02, 0x04, 0x08, 0x10, 0x1F},  // 'Z'
+    {0x0E, 0x08, 0x08, 0x08, 0x08, 0x08, 0x0E},  // '['
+    {0x00, 0x10, 0x08, 0x04, 0x02, 0x01, 0x00},  // '\'
+    {0x0E, 0x02, 0x02, 0x02, 0x02, 0x02, 0x0E},  // ']'
+    {0x04, 0x0A, 0x11, 0x00, 0x00, 0x00, 0x00},  // '^'
+    {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x1F},  // '_'
+};
+
+const int GLYPH_SCALE = 2;
+const int GLYPH_ADVANCE = 6 * GLYPH_SCALE;
+
+// PNG frames are written with stored (uncompressed) deflate blocks: encoding
+// stays a single linear pass into a preallocated buffer, and the consumer
+// (usually ffmpeg) recompresses anyway.
+const size_t DEFLATE_BLOCK_SIZE = 65535;
+
+const std::array<uint32_t, 256>& crcTable() {
+    static const std::array<uint32_t, 256> table = [] {
+        std::array<uint32_t, 256> t{};
+        for (uint32_t n = 0; n < 256; n++) {
+            uint32_t c = n;
+            for (int k = 0; k < 8; k++) {
+                c = (c & 1) ? 0xEDB88320u ^ (c >> 1) : c >> 1;
+            }
+            t[n] = c;
+        }
+        return t;
+    }();
+    return table;
+}
+
+uint32_t crc32(const uint8_t* data, size_t size) {
+    const auto& table = crcTable();
+    uint32_t c = 0xFFFFFFFFu;
+    for (size_t i = 0; i < size; i++) {
+        c = table[(c ^ data[i]) & 0xFF] ^ (c >> 8);
+    }
+    return c ^ 0xFFFFFFFFu;
+}
+
+uint8_t* putU32(uint8_t* out, uint32_t value) {
+    out[0] = static_cast<uint8_t>(value >> 24);
+    out[1] = static_cast<uint8_t>(value >> 16);
+    out[2] = static_cast<uint8_t>(value >> 8);
+    out[3] = static_cast<uint8_t>(value);
+    return out + 4;
+}
+
+// Writes the chunk length, type and trailing CRC around data already in place
+uint8_t* finishChunk(uint8_t* chunkStart, uint32_t dataLength) {
+    putU32(chunkStart, dataLength);
+    uint32_t crc = crc32(chunkStart + 4, dataLength + 4);
+    return putU32(chunkStart + 8 + dataLength, crc);
+}
+
+size_t pngSize(int width, int height) {
+    size_t rawSize = static_cast<size_t>(height) * (1 + static_cast<size_t>(width) * 4);
+    size_t blocks = (rawSize + DEFLATE_BLOCK_SIZE - 1) / DEFLATE_BLOCK_SIZE;
+    size_t zlibSize = 2 + blocks * 5 + rawSize + 4;
+    return 8 + (12 + 13) + (12 + zlibSize) + 12;
+}
+
+// A per-frame file name pattern is handed to snprintf, so it may contain
+// nothing but "%%" escapes and exactly one "%d" with an optional zero-padded
+// width, e.g. "frame%05d.png"
+bool isFramePattern(const std::string& pattern) {
+    int conversions = 0;
+    for (size_t i = 0; i < pattern.size(); i++) {
+        if (pattern[i] != '%') continue;
+        if (++i < pattern.size() && pattern[i] == '%') continue;
+        while (i < pattern.size() && pattern[i] >= '0' && pattern[i] <= '9') i++;
+        if (i == pattern.size() || pattern[i] != 'd') return false;
+        conversions++;
+    }
+    return conversions == 1;
+}
+
+} // namespace
+
+SoftwareBackend::SoftwareBackend(int width, int height,
+                                 OutputFormat format, const std::string& outputPath)
+    : width(width), height(height), currentPixel(0)
+    , format(format), outputPath(outputPath), output(nullptr)
+    , outputIsPipe(false), outputPerFrame(false), outputFailed(false), frameCount(0) {}
+
+SoftwareBackend::~SoftwareBackend() {
+    cleanup();
+}
+
+bool SoftwareBackend::initialize() {
+    pixels.assign(static_cast<size_t>(width) * height, 0);
+    setColor({0, 0, 0, 255});
+
+    if (format == OutputFormat::None) {
+        return true;
+    }
+
+    if (format == OutputFormat::PngSequence) {
+        pngBuffer.resize(pngSize(width, height));
+    }
+
+    if (outputPath.empty() || outputPath == "-") {
+        output = stdout;
+    } else if (outputPath[0] == '|') {
+        output = popen(outputPath.c_str() + 1, "w");
+        outputIsPipe = true;
+    } else if (format == OutputFormat::PngSequence &&
+               outputPath.find('%') != std::string::npos) {
+        if (!isFramePattern(outputPath)) {
+            std::cerr << "Frame pattern must contain exactly one %d (like frame%05d.png): "
+                      << outputPath << std::endl;
+            return false;
+        }
+        outputPerFrame = true;
+        pathBuffer.resize(outputPath.size() + 32);
+        return true;
+    } else {
+        output = std::fopen(outputPath.c_str(), "wb");
+    }
+
+    if (!output) {
+        std::cerr << "Could not open frame output: " << outputPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void SoftwareBackend::cleanup() {
+    if (output) {
+        if (outputIsPipe) {
+            pclose(output);
+        } else if (output == stdout) {
+            std::fflush(output);
+        } else if (std::fclose(output) != 0 && !outputFailed) {
+            std::cerr << "Could not finish frame output: " << outputPath << std::endl;
+            outputFailed = true;
+        }
+        output = nullptr;
+    }
+}
+
+void SoftwareBackend::clear() {
+    uint8_t black[4] = {0, 0, 0, 255};
+    uint32_t pixel;
+    std::memcpy(&pixel, black, sizeof(pixel));
+    std::fill(pixels.begin(), pixels.end(), pixel);
+}
+
+void SoftwareBackend::present() {
+    frameCount++;
+    if (outputFailed) return;
+
+    bool written = true;
+    switch (format) {
+        case OutputFormat::RawVideo:
+            written = writeFrame(getPixels(), pixels.size() * sizeof(uint32_t));
+            break;
+        case OutputFormat::PngSequence:
+            written = writeFrame(pngBuffer.data(), encodePng());
+            break;
+        case OutputFormat::None:
+            break;
+    }
+    if (!written) {
+        std::cerr << "Could not write frame " << frameCount - 1 << " to "
+                  << (outputPerFrame ? pathBuffer.data() : outputPath.c_str()) << std::endl;
+        outputFailed = true;
+    }
+}
+
+void SoftwareBackend::setColor(const Color& color) {
+    uint8_t rgba[4] = {color.r, color.g, color.b, color.a};
+    std::memcpy(&currentPixel, rgba, sizeof(currentPixel));
+}
+
+void SoftwareBackend::fillClipped(int x, int y, int w, int h) {
+    int x0 = std::max(x, 0);
+    int y0 = std::max(y, 0);
+    int x1 = std::min(x + w, width);
+    int y1 = std::min(y + h, height);
+    if (x0 >= x1 || y0 >= y1) return;
+
+    for (int row = y0; row < y1; row++) {
+        uint32_t* line = pixels.data() + static_cast<size_t>(row) * width;
+        std::fill(line + x0, line + x1, currentPixel);
+    }
+}
+
+void SoftwareBackend::drawRect(int x, int y, int width, int height, bool filled) {
+    if (filled) {
+        fillClipped(x, y, width, height);
+    } else {
+        // Same pixel coverage as SDL_RenderDrawRect: a one pixel outline
+        fillClipped(x, y, width, 1);
+        fillClipped(x, y + height - 1, width, 1);
+        fillClipped(x, y, 1, height);
+        fillClipped(x + width - 1, y, 1, height);
+    }
+}
+
+void SoftwareBackend::drawText(const char* text, int x, int y) {
+    for (const char* c = text; *c; c++, x += GLYPH_ADVANCE) {
+        int code = static_cast<unsigned char>(*c);
+        if (code >= 'a' && code <= 'z') {
+            code -= 'a' - 'A';
+        }
+        if (code < 32 || code > 95) continue;
+
+        const uint8_t* glyph = FONT_5X7[code - 32];
+        for (int row = 0; row < 7; row++) {
+            for (int col = 0; col < 5; col++) {
+                if (glyph[row] & (0x10 >> col)) {
+                    fillClipped(x + col * GLYPH_SCALE, y + row * GLYPH_SCALE,
+                                GLYPH_SCALE, GLYPH_SCALE);
+                }
+            }
+        }
+    }
+}
+
+void SoftwareBackend::setTilePalette(const Color* colors, int count) {
+    palette.resize(count);
+    for (int i = 0; i < count; i++) {
+        uint8_t rgba[4] = {colors[i].r, colors[i].g, colors[i].b, colors[i].a};
+        std::memcpy(&palette[i], rgba, sizeof(uint32_t));
+    }
+}
+
+void SoftwareBackend::drawTiles(const TileQuad* quads, int count) {
+    uint32_t savedPixel = currentPixel;
+    for (int i = 0; i < count; i++) {
+        currentPixel = palette[quads[i].tile];
+        fillClipped(quads[i].x, quads[i].y, quads[i].width, quads[i].height);
+    }
+    currentPixel = savedPixel;
+}
+
+size_t SoftwareBackend::encodePng() {
+    static const uint8_t signature[8] = {0x89, 'P', 'N', 'G', '\r', '\n', 0x1A, '\n'};
+
+    uint8_t* out = pngBuffer.data();
+    std::memcpy(out, signature, sizeof(signature));
+    out += sizeof(signature);
+
+    // IHDR: 8-bit RGBA, no interlace
+    uint8_t* chunk = out;
+    std::memcpy(chunk + 4, "IHDR", 4);
+    uint8_t* data = putU32(chunk + 8, width);
+    data = putU32(data, height);
+    data[0] = 8;
+    data[1] = 6;
+    data[2] = 0;
+    data[3] = 0;
+    data[4] = 0;
+    out = finishChunk(chunk, 13);
+
+    // IDAT: zlib stream of stored blocks, each scanline prefixed with filter type 0
+    chunk = out;
+    std::memcpy(chunk + 4, "IDAT", 4);
+    data = chunk + 8;
+    *data++ = 0x78;
+    *data++ = 0x01;
+
+    const size_t rowBytes = static_cast<size_t>(width) * 4;
+    const size_t rawSize = static_cast<size_t>(height) * (1 + rowBytes);
+    const uint8_t* source = getPixels();
+    size_t rawOffset = 0;
+    uint32_t adlerA = 1, adlerB = 0;
+
+    while (rawOffset < rawSize) {
+        size_t blockSize = std::min(DEFLATE_BLOCK_SIZE, rawSize - rawOffset);
+        *data++ = (rawOffset + blockSize == rawSize) ? 1 : 0;
+        data[0] = static_cast<uint8_t>(blockSize);
+        data[1] = static_cast<uint8_t>(blockSize >> 8);
+        data[2] = static_cast<uint8_t>(~blockSize);
+        data[3] = static_cast<uint8_t>(~blockSize >> 8);
+        data += 4;
+
+        uint8_t* blockStart = data;
+        size_t remaining = blockSize;
+        while (remaining > 0) {
+            // Copy the rest of the current scanline (or its filter byte)
+            size_t rowPos = rawOffset % (1 + rowBytes);
+            if (rowPos == 0) {
+                *data++ = 0;
+                rawOffset++;
+                remaining--;
+                continue;
+            }
+            size_t n = std::min(remaining, 1 + rowBytes - rowPos);
+            std::memcpy(data, source + (rawOffset / (1 + rowBytes)) * rowBytes + rowPos - 1, n);
+            data += n;
+            rawOffset += n;
+            remaining -= n;
+        }
+
+        // Adler-32 over the block, reducing often enough to avoid overflow
+        for (const uint8_t* p = blockStart; p < data; ) {
+            const uint8_t* end = p + std::min<size_t>(5552, data - p);
+            for (; p < end; p++) {
+                adlerA += *p;
+                adlerB += adlerA;
+            }
+            adlerA %= 65521;
+            adlerB %= 65521;
+        }
+    }
+    data = putU32(data, (adlerB << 16) | adlerA);
+    out = finishChunk(chunk, static_cast<uint32_t>(data - (chunk + 8)));
+
+    chunk = out;
+    std::memcpy(chunk + 4, "IEND", 4);
+    out = finishChunk(chunk, 0);
+
+    return out - pngBuffer.data();
+}
+
+bool SoftwareBackend::writeFrame(const uint8_t* data, size_t size) {
+    FILE* target = output;
+    if (outputPerFrame) {
+        std::snprintf(pathBuffer.data(), pathBuffer.size(), outputPath.c_str(),
+                      static_cast<int>(frameCount - 1));
+        target = std::fopen(pathBuffer.data(), "wb");
+    }
+    if (!target) return false;
+
+    bool ok = std::fwrite(data, 1, size, target) == size;
+    if (outputPerFrame) {
+        ok = std::fclose(target) == 0 && ok;
+    }
+    return ok;
+}
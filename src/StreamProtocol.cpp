@@ -0,0 +1,232 @@
+#include "StreamProtocol.h"
+#include <cstring>
+
+namespace stream {
+
+namespace {
+
+class Writer {
+    uint8_t* out;
+    size_t pos;
+
+public:
+    explicit Writer(uint8_t* out) : out(out), pos(HEADER_SIZE) {}
+
+    void u8(uint8_t value) { out[pos++] = value; }
+    void u16(uint16_t value) { u8(value & 0xFF); u8(value >> 8); }
+    void u32(uint32_t value) { u16(value & 0xFFFF); u16(value >> 16); }
+    void u64(uint64_t value) { u32(value & 0xFFFFFFFF); u32(value >> 32); }
+
+    void row(const uint8_t* cells, int width) {
+        size_t bytes = rowBytes(width);
+        std::memset(out + pos, 0, bytes);
+        for (int x = 0; x < width; x++) {
+            size_t bit = static_cast<size_t>(x) * 3;
+            uint32_t value = cells[x] & 7u;
+            out[pos + bit / 8] |= static_cast<uint8_t>(value << (bit % 8));
+            if (bit % 8 > 5) {
+                out[pos + bit / 8 + 1] |= static_cast<uint8_t>(value >> (8 - bit % 8));
+            }
+        }
+        pos += bytes;
+    }
+
+    size_t finish(MessageType type) {
+        out[0] = static_cast<uint8_t>(pos & 0xFF);
+        out[1] = static_cast<uint8_t>(pos >> 8);
+        out[2] = static_cast<uint8_t>(type);
+        return pos;
+    }
+};
+
+class Reader {
+    const uint8_t* data;
+    size_t size;
+    size_t pos;
+    bool ok;
+
+public:
+    Reader(const uint8_t* data, size_t size) : data(data), size(size), pos(HEADER_SIZE), ok(true) {}
+
+    bool valid() const { return ok && pos == size; }
+
+    uint8_t u8() {
+        if (pos >= size) {
+            ok = false;
+            return 0;
+        }
+        return data[pos++];
+    }
+    uint16_t u16() { uint16_t lo = u8(); return static_cast<uint16_t>(lo | (u8() << 8)); }
+    uint32_t u32() { uint32_t lo = u16(); return lo | (static_cast<uint32_t>(u16()) << 16); }
+    uint64_t u64() { uint64_t lo = u32(); return lo | (static_cast<uint64_t>(u32()) << 32); }
+
+    void row(uint8_t* cells, int width) {
+        size_t bytes = rowBytes(width);
+        if (pos + bytes > size) {
+            ok = false;
+            return;
+        }
+        for (int x = 0; x < width; x++) {
+            size_t bit = static_cast<size_t>(x) * 3;
+            uint32_t value = data[pos + bit / 8] >> (bit % 8);
+            if (bit % 8 > 5) {
+                value |= static_cast<uint32_t>(data[pos + bit / 8 + 1]) << (8 - bit % 8);
+            }
+            cells[x] = static_cast<uint8_t>(value & 7u);
+        }
+        pos += bytes;
+    }
+};
+
+void writePiece(Writer& writer, const GameState& state) {
+    writer.u8(state.pieceType);
+    writer.u8(state.rotation);
+    writer.u8(static_cast<uint8_t>(state.x));
+    writer.u8(static_cast<uint8_t>(state.y));
+}
+
+void writeStats(Writer& writer, const GameState& state) {
+    writer.u32(state.score);
+    writer.u16(state.level);
+    writer.u32(state.linesCleared);
+}
+
+void readPiece(Reader& reader, GameState& state) {
+    state.pieceType = reader.u8();
+    state.rotation = reader.u8();
+    state.x = static_cast<int8_t>(reader.u8());
+    state.y = static_cast<int8_t>(reader.u8());
+}
+
+void readStats(Reader& reader, GameState& state) {
+    state.score = reader.u32();
+    state.level = reader.u16();
+    state.linesCleared = reader.u32();
+}
+
+} // namespace
+
+uint64_t stateHash(const GameState& state) {
+    uint64_t hash = 1469598103934665603ull;
+    auto mix = [&hash](uint64_t value) {
+        hash ^= value;
+        hash *= 1099511628211ull;
+    };
+
+    mix(state.width);
+    mix(state.height);
+    for (int y = 0; y < state.height; y++) {
+        for (int x = 0; x < state.width; x++) {
+            mix(state.cells[y][x]);
+        }
+    }
+    mix(state.pieceType);
+    mix(state.rotation);
+    mix(static_cast<uint8_t>(state.x));
+    mix(static_cast<uint8_t>(state.y));
+    mix(state.score);
+    mix(state.level);
+    mix(state.linesCleared);
+    mix(state.gameOver);
+    return hash;
+}
+
+size_t encodeKeyframe(const GameState& state, uint8_t* out) {
+    Writer writer(out);
+    writer.u32(state.tick);
+    writer.u8(state.width);
+    writer.u8(state.height);
+    for (int y = 0; y < state.height; y++) {
+        writer.row(state.cells[y], state.width);
+    }
+    writePiece(writer, state);
+    writeStats(writer, state);
+    writer.u8(state.gameOver);
+    writer.u64(stateHash(state));
+    return writer.finish(MessageType::Keyframe);
+}
+
+size_t encodeDelta(const GameState& previous, const GameState& current, uint8_t* out) {
+    uint64_t changedRows = 0;
+    for (int y = 0; y < current.height; y++) {
+        if (std::memcmp(previous.cells[y], current.cells[y], current.width) != 0) {
+            changedRows |= 1ull << y;
+        }
+    }
+
+    uint8_t fields = 0;
+    if (changedRows) fields |= FIELD_ROWS;
+    if (previous.pieceType != current.pieceType || previous.rotation != current.rotation ||
+        previous.x != current.x || previous.y != current.y) {
+        fields |= FIELD_PIECE;
+    }
+    if (previous.score != current.score || previous.level != current.level ||
+        previous.linesCleared != current.linesCleared) {
+        fields |= FIELD_STATS;
+    }
+    if (previous.gameOver != current.gameOver) fields |= FIELD_STATUS;
+
+    Writer writer(out);
+    writer.u32(current.tick);
+    writer.u8(fields);
+    if (fields & FIELD_ROWS) {
+        writer.u64(changedRows);
+        for (int y = 0; y < current.height; y++) {
+            if (changedRows & (1ull << y)) {
+                writer.row(current.cells[y], current.width);
+            }
+        }
+    }
+    if (fields & FIELD_PIECE) writePiece(writer, current);
+    if (fields & FIELD_STATS) writeStats(writer, current);
+    if (fields & FIELD_STATUS) writer.u8(current.gameOver);
+    return writer.finish(MessageType::Delta);
+}
+
+bool decodeMessage(const uint8_t* data, size_t size, GameState& state,
+                   MessageType& type, uint64_t& keyframeHash) {
+    if (size < HEADER_SIZE || (data[0] | (data[1] << 8)) != static_cast<int>(size)) {
+        return false;
+    }
+    type = static_cast<MessageType>(data[2]);
+    Reader reader(data, size);
+
+    if (type == MessageType::Keyframe) {
+        state.tick = reader.u32();
+        state.width = reader.u8();
+        state.height = reader.u8();
+        if (state.width > MAX_BOARD_WIDTH || state.height > MAX_BOARD_HEIGHT) {
+            return false;
+        }
+        for (int y = 0; y < state.height; y++) {
+            reader.row(state.cells[y], state.width);
+        }
+        readPiece(reader, state);
+        readStats(reader, state);
+        state.gameOver = reader.u8();
+        keyframeHash = reader.u64();
+        return reader.valid();
+    }
+
+    if (type == MessageType::Delta) {
+        state.tick = reader.u32();
+        uint8_t fields = reader.u8();
+        if (fields & FIELD_ROWS) {
+            uint64_t changedRows = reader.u64();
+            for (int y = 0; y < state.height; y++) {
+                if (changedRows & (1ull << y)) {
+                    reader.row(state.cells[y], state.width);
+                }
+            }
+        }
+        if (fields & FIELD_PIECE) readPiece(reader, state);
+        if (fields & FIELD_STATS) readStats(reader, state);
+        if (fields & FIELD_STATUS) state.gameOver = reader.u8();
+        return reader.valid();
+    }
+
+    return false;
+}
+
+} // namespace stream
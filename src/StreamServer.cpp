@@ -0,0 +1,240 @@
+#include "StreamServer.h"
+#include "BlockDropGame.h"
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace {
+
+// Bytes queued per subscriber before waiting for the socket to drain
+const size_t SEND_BATCH = 64 * 1024;
+
+bool setNonBlocking(int fd) {
+    int flags = fcntl(fd, F_GETFL, 0);
+    return flags >= 0 && fcntl(fd, F_SETFL, flags | O_NONBLOCK) == 0;
+}
+
+} // namespace
+
+BroadcastRing::BroadcastRing() : slots(new Slot[CAPACITY]), head(0) {
+    for (size_t i = 0; i < CAPACITY; i++) {
+        slots[i].sequence.store(0, std::memory_order_relaxed);
+        slots[i].size = 0;
+    }
+}
+
+void BroadcastRing::push(const uint8_t* data, size_t size) {
+    uint64_t index = head.load(std::memory_order_relaxed);
+    Slot& slot = slots[index & (CAPACITY - 1)];
+
+    slot.sequence.store(2 * index + 1, std::memory_order_relaxed);
+    std::atomic_thread_fence(std::memory_order_release);
+    slot.size = static_cast<uint16_t>(size);
+    std::memcpy(slot.data, data, size);
+    slot.sequence.store(2 * index + 2, std::memory_order_release);
+
+    head.store(index + 1, std::memory_order_release);
+}
+
+size_t BroadcastRing::read(uint64_t index, uint8_t* out) const {
+    const Slot& slot = slots[index & (CAPACITY - 1)];
+    const uint64_t expected = 2 * index + 2;
+
+    if (slot.sequence.load(std::memory_order_acquire) != expected) {
+        return 0;
+    }
+    size_t size = slot.size;
+    if (size > stream::MAX_MESSAGE_SIZE) {
+        return 0;
+    }
+    std::memcpy(out, slot.data, size);
+
+    // If the producer started rewriting the slot meanwhile, the copy is torn
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (slot.sequence.load(std::memory_order_relaxed) != expected) {
+        return 0;
+    }
+    return size;
+}
+
+StreamServer::StreamServer(const std::string& socketPath, int keyframeInterval)
+    : socketPath(socketPath), keyframeInterval(keyframeInterval), listenFd(-1)
+    , lastKeyframe(0), previousState{}, currentState{}, tick(0), running(false) {}
+
+StreamServer::~StreamServer() {
+    stop();
+}
+
+bool StreamServer::start() {
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        std::cerr << "Stream socket path too long: " << socketPath << std::endl;
+        return false;
+    }
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath.c_str(), sizeof(address.sun_path) - 1);
+
+    listenFd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (listenFd < 0) {
+        std::cerr << "Could not create stream socket: " << std::strerror(errno) << std::endl;
+        return false;
+    }
+
+    unlink(socketPath.c_str());
+    if (bind(listenFd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0 ||
+        listen(listenFd, 16) < 0 || !setNonBlocking(listenFd)) {
+        std::cerr << "Could not listen on " << socketPath << ": " << std::strerror(errno) << std::endl;
+        close(listenFd);
+        listenFd = -1;
+        return false;
+    }
+
+    running = true;
+    ioThread = std::thread(&StreamServer::ioLoop, this);
+    return true;
+}
+
+void StreamServer::stop() {
+    if (!running.exchange(false)) return;
+
+    ioThread.join();
+    for (auto& subscriber : subscribers) {
+        close(subscriber.fd);
+    }
+    subscribers.clear();
+    close(listenFd);
+    listenFd = -1;
+    unlink(socketPath.c_str());
+}
+
+template <int Width, int Height>
+void StreamServer::capture(const BasicBlockDropGame<Width, Height>& game, stream::GameState& state) const {
+    const auto& board = game.getBoard();
+    state.width = Width;
+    state.height = Height;
+    for (int y = 0; y < Height; y++) {
+        for (int x = 0; x < Width; x++) {
+            state.cells[y][x] = static_cast<uint8_t>(board[y][x]);
+        }
+    }
+    state.pieceType = static_cast<uint8_t>(game.getCurrentPieceType());
+    state.rotation = static_cast<uint8_t>(game.getCurrentRotation());
+    state.x = static_cast<int8_t>(game.getCurrentX());
+    state.y = static_cast<int8_t>(game.getCurrentY());
+    state.score = game.getScore();
+    state.level = static_cast<uint16_t>(game.getLevel());
+    state.linesCleared = game.getLinesCleared();
+    state.gameOver = game.isGameOver();
+}
+
+template <int Width, int Height>
+void StreamServer::publish(const BasicBlockDropGame<Width, Height>& game) {
+    capture(game, currentState);
+    currentState.tick = tick;
+
+    if (tick > 0) {
+        size_t size = stream::encodeDelta(previousState, currentState, messageBuffer);
+        ring.push(messageBuffer, size);
+    }
+    if (tick % keyframeInterval == 0) {
+        size_t size = stream::encodeKeyframe(currentState, messageBuffer);
+        uint64_t index = ring.getHead();
+        ring.push(messageBuffer, size);
+        lastKeyframe.store(index, std::memory_order_release);
+    }
+
+    previousState = currentState;
+    tick++;
+}
+
+void StreamServer::ioLoop() {
+    std::vector<pollfd> pollFds;
+
+    while (running.load(std::memory_order_relaxed)) {
+        pollFds.clear();
+        pollFds.push_back({listenFd, POLLIN, 0});
+        for (const auto& subscriber : subscribers) {
+            short events = subscriber.pending.size() > subscriber.pendingOffset ? POLLOUT : 0;
+            pollFds.push_back({subscriber.fd, events, 0});
+        }
+        // Short timeout: new messages appear in the ring without any wakeup
+        poll(pollFds.data(), pollFds.size(), 1);
+
+        acceptSubscribers();
+
+        for (size_t i = 0; i < subscribers.size(); ) {
+            bool hungUp = i + 1 < pollFds.size() && (pollFds[i + 1].revents & (POLLHUP | POLLERR));
+            if (hungUp || !serviceSubscriber(subscribers[i])) {
+                close(subscribers[i].fd);
+                subscribers.erase(subscribers.begin() + i);
+                pollFds.erase(pollFds.begin() + i + 1);
+            } else {
+                i++;
+            }
+        }
+    }
+}
+
+void StreamServer::acceptSubscribers() {
+    while (true) {
+        int fd = accept(listenFd, nullptr, nullptr);
+        if (fd < 0) return;
+
+        if (!setNonBlocking(fd)) {
+            close(fd);
+            continue;
+        }
+        Subscriber subscriber;
+        subscriber.fd = fd;
+        subscriber.cursor = lastKeyframe.load(std::memory_order_acquire);
+        subscriber.pending.reserve(SEND_BATCH + stream::MAX_MESSAGE_SIZE);
+        subscriber.pendingOffset = 0;
+        subscribers.push_back(std::move(subscriber));
+    }
+}
+
+bool StreamServer::serviceSubscriber(Subscriber& subscriber) {
+    uint64_t head = ring.getHead();
+    if (head - subscriber.cursor > BroadcastRing::CAPACITY) {
+        return false;  // Lapped: too slow to keep up
+    }
+
+    // Drop what the socket already took so the buffer stays bounded
+    if (subscriber.pendingOffset > 0) {
+        subscriber.pending.erase(subscriber.pending.begin(),
+                                 subscriber.pending.begin() + subscriber.pendingOffset);
+        subscriber.pendingOffset = 0;
+    }
+
+    uint8_t message[stream::MAX_MESSAGE_SIZE];
+    while (subscriber.pending.size() - subscriber.pendingOffset < SEND_BATCH &&
+           subscriber.cursor < head) {
+        size_t size = ring.read(subscriber.cursor, message);
+        if (size == 0) {
+            return false;  // Overwritten while we were reading it
+        }
+        subscriber.pending.insert(subscriber.pending.end(), message, message + size);
+        subscriber.cursor++;
+    }
+
+    while (subscriber.pendingOffset < subscriber.pending.size()) {
+        ssize_t sent = send(subscriber.fd, subscriber.pending.data() + subscriber.pendingOffset,
+                            subscriber.pending.size() - subscriber.pendingOffset, MSG_NOSIGNAL);
+        if (sent < 0) {
+            return errno == EAGAIN || errno == EWOULDBLOCK || errno == EINTR;
+        }
+        subscriber.pendingOffset += sent;
+    }
+    subscriber.pending.clear();
+    subscriber.pendingOffset = 0;
+    return true;
+}
+
+#define BLOCKDROP_INSTANTIATE_STREAM(width, height) \
+    template void StreamServer::publish(const BasicBlockDropGame<width, height>& game);
+BLOCKDROP_GEOMETRIES(BLOCKDROP_INSTANTIATE_STREAM)
@@ -0,0 +1,353 @@
+#include "TrainingExport.h"
+#include <algorithm>
+#include <cstring>
+#include <fcntl.h>
+#include <iostream>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <zlib.h>
+
+namespace training {
+
+namespace {
+
+const char FILE_MAGIC[4] = {'B', 'D', 'T', 'R'};
+const char CHUNK_MAGIC[4] = {'C', 'H', 'N', 'K'};
+
+// Fastest zlib level: the columns are low-entropy, and the writers must keep
+// up with self-play
+const int COMPRESSION_LEVEL = 1;
+
+uint32_t valueSize(uint16_t column, int boardHeight) {
+    switch (column) {
+        case GAME_ID: return 8;
+        case MOVE_INDEX: return 4;
+        case BOARD: return 4 * boardHeight;
+        case PIECE: return 1;
+        case CANDIDATE_COUNT: return 2;
+        case CHOSEN: return 2;
+        case FINAL_SCORE: return 4;
+        case FINAL_LINES: return 4;
+        case MOVES_REMAINING: return 4;
+        case TRUNCATED: return 1;
+        case CANDIDATE_X: return 1;
+        case CANDIDATE_ROTATION: return 1;
+        case CANDIDATE_SCORE: return 4;
+    }
+    return 2;  // Feature columns
+}
+
+template <typename T>
+void overwrite(std::vector<uint8_t>& column, size_t index, T value) {
+    std::memcpy(column.data() + index * sizeof(T), &value, sizeof(T));
+}
+
+} // namespace
+
+TrainingWriter::TrainingWriter()
+    : file(nullptr), boardWidth(0), boardHeight(0), bytesWritten(0), recordsWritten(0), failed(false) {}
+
+TrainingWriter::~TrainingWriter() {
+    close();
+}
+
+bool TrainingWriter::open(const std::string& path, int boardWidth, int boardHeight,
+                          Scorer scorer, const std::string& scorerName) {
+    this->boardWidth = boardWidth;
+    this->boardHeight = boardHeight;
+    file = std::fopen(path.c_str(), "wb");
+    if (!file) {
+        std::cerr << "Could not open training export " << path << std::endl;
+        return false;
+    }
+
+    FileHeader header = {};
+    std::memcpy(header.magic, FILE_MAGIC, sizeof(header.magic));
+    header.version = FORMAT_VERSION;
+    header.boardWidth = boardWidth;
+    header.boardHeight = boardHeight;
+    header.featureCount = BlockDropRules::FEATURE_COUNT;
+    header.columnCount = COLUMN_COUNT;
+    header.scorer = static_cast<uint8_t>(scorer);
+    scorerName.copy(header.scorerName, sizeof(header.scorerName) - 1);
+    if (std::fwrite(&header, sizeof(header), 1, file) != 1) {
+        std::cerr << "Failed to write training export header" << std::endl;
+        failed = true;
+        return false;
+    }
+    bytesWritten = sizeof(header);
+    return true;
+}
+
+bool TrainingWriter::close() {
+    if (!file) return !failed;
+    if (std::fclose(file) != 0) {
+        failed = true;
+    }
+    file = nullptr;
+    if (failed) {
+        std::cerr << "Training export is incomplete" << std::endl;
+    }
+    return !failed;
+}
+
+bool TrainingWriter::writeChunk(const std::vector<uint8_t>& chunk, uint32_t records) {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (!file || failed) return false;
+
+    if (std::fwrite(chunk.data(), 1, chunk.size(), file) != chunk.size()) {
+        failed = true;
+        return false;
+    }
+    bytesWritten.fetch_add(chunk.size(), std::memory_order_relaxed);
+    recordsWritten.fetch_add(records, std::memory_order_relaxed);
+    return true;
+}
+
+ChunkBuilder::ChunkBuilder(TrainingWriter& writer, size_t chunkRecords)
+    : writer(writer), chunkRecords(chunkRecords), gameId(0), moveIndex(0) {
+    reset();
+}
+
+void ChunkBuilder::reset() {
+    for (auto& column : columns) {
+        column.clear();
+    }
+    recordCount = 0;
+    candidateCount = 0;
+    gameStart = 0;
+    minGameId = UINT64_MAX;
+    maxGameId = 0;
+    gameCount = 0;
+    bestFinalScore = INT32_MIN;
+}
+
+template <typename T>
+void ChunkBuilder::append(Column column, T value) {
+    const uint8_t* bytes = reinterpret_cast<const uint8_t*>(&value);
+    columns[column].insert(columns[column].end(), bytes, bytes + sizeof(T));
+}
+
+void ChunkBuilder::beginGame(uint64_t id) {
+    gameId = id;
+    moveIndex = 0;
+    gameStart = recordCount;
+}
+
+template <int Width, int Height>
+void ChunkBuilder::recordDecision(const BasicBlockDropGame<Width, Height>& game,
+                                  const std::vector<BlockDropRules::MoveCandidate>& candidates,
+                                  size_t chosen) {
+    append(GAME_ID, gameId);
+    append(MOVE_INDEX, moveIndex++);
+
+    for (auto row : game.getRows()) {
+        append(BOARD, static_cast<uint32_t>(row));
+    }
+
+    append(PIECE, static_cast<uint8_t>(game.getCurrentPieceType()));
+    append(CANDIDATE_COUNT, static_cast<uint16_t>(candidates.size()));
+    append(CHOSEN, static_cast<uint16_t>(chosen));
+    // Outcome columns are filled in by endGame
+    append(FINAL_SCORE, int32_t(0));
+    append(FINAL_LINES, int32_t(0));
+    append(MOVES_REMAINING, uint32_t(0));
+    append(TRUNCATED, uint8_t(0));
+
+    for (const auto& candidate : candidates) {
+        const auto& f = candidate.features;
+        append(CANDIDATE_X, static_cast<int8_t>(candidate.x));
+        append(CANDIDATE_ROTATION, static_cast<uint8_t>(candidate.rotation));
+        const int values[BlockDropRules::FEATURE_COUNT] = {
+            f.maxHeight, f.aggregateHeight, f.completeLines, f.holes,
+            f.bumpiness, f.totalTiles, f.nearlyCompleteRows, f.emptyColumns
+        };
+        for (int i = 0; i < BlockDropRules::FEATURE_COUNT; i++) {
+            append(static_cast<Column>(FEATURE_FIRST + i), static_cast<int16_t>(values[i]));
+        }
+        append(CANDIDATE_SCORE, static_cast<float>(candidate.score));
+    }
+
+    recordCount++;
+    candidateCount += candidates.size();
+}
+
+void ChunkBuilder::finishGame(int32_t finalScore, int32_t finalLines, bool truncated) {
+    for (size_t i = gameStart; i < recordCount; i++) {
+        overwrite(columns[FINAL_SCORE], i, finalScore);
+        overwrite(columns[FINAL_LINES], i, finalLines);
+        overwrite(columns[MOVES_REMAINING], i, static_cast<uint32_t>(recordCount - 1 - i));
+        overwrite(columns[TRUNCATED], i, static_cast<uint8_t>(truncated));
+    }
+    bestFinalScore = std::max(bestFinalScore, finalScore);
+    minGameId = std::min(minGameId, gameId);
+    maxGameId = std::max(maxGameId, gameId);
+    gameCount++;
+    gameStart = recordCount;
+
+    if (recordCount >= chunkRecords) {
+        flush();
+    }
+}
+
+bool ChunkBuilder::flush() {
+    // Only completed games go out; a game in progress stays buffered
+    if (gameStart == 0) return true;
+    if (gameStart != recordCount) {
+        std::cerr << "ChunkBuilder::flush called in the middle of a game" << std::endl;
+        return false;
+    }
+
+    const size_t directorySize = sizeof(ColumnEntry) * COLUMN_COUNT;
+    chunk.resize(sizeof(ChunkHeader) + directorySize);
+
+    ColumnEntry directory[COLUMN_COUNT];
+    uint64_t payloadSize = 0;
+    for (uint16_t i = 0; i < COLUMN_COUNT; i++) {
+        const auto& raw = columns[i];
+        uLongf storedSize = compressBound(raw.size());
+        scratch.resize(storedSize);
+
+        ColumnEntry& entry = directory[i];
+        entry = {};
+        entry.column = i;
+        entry.valueSize = valueSize(i, writer.getBoardHeight());
+        entry.rawSize = raw.size();
+        entry.offset = payloadSize;
+
+        if (compress2(scratch.data(), &storedSize, raw.data(), raw.size(), COMPRESSION_LEVEL) == Z_OK &&
+            storedSize < raw.size()) {
+            entry.codec = static_cast<uint8_t>(Codec::Zlib);
+            entry.storedSize = storedSize;
+            chunk.insert(chunk.end(), scratch.begin(), scratch.begin() + storedSize);
+        } else {
+            entry.codec = static_cast<uint8_t>(Codec::Raw);
+            entry.storedSize = raw.size();
+            chunk.insert(chunk.end(), raw.begin(), raw.end());
+        }
+        payloadSize += entry.storedSize;
+    }
+
+    ChunkHeader header = {};
+    std::memcpy(header.magic, CHUNK_MAGIC, sizeof(header.magic));
+    header.recordCount = recordCount;
+    header.candidateCount = candidateCount;
+    header.columnCount = COLUMN_COUNT;
+    header.payloadSize = payloadSize;
+    header.minGameId = minGameId;
+    header.maxGameId = maxGameId;
+    header.bestFinalScore = bestFinalScore;
+    header.gameCount = gameCount;
+    std::memcpy(chunk.data(), &header, sizeof(header));
+    std::memcpy(chunk.data() + sizeof(header), directory, directorySize);
+
+    bool written = writer.writeChunk(chunk, recordCount);
+    reset();
+    return written;
+}
+
+#define BLOCKDROP_INSTANTIATE_RECORD(width, height) \
+    template void ChunkBuilder::recordDecision(const BasicBlockDropGame<width, height>& game, \
+                                               const std::vector<BlockDropRules::MoveCandidate>& candidates, \
+                                               size_t chosen);
+BLOCKDROP_GEOMETRIES(BLOCKDROP_INSTANTIATE_RECORD)
+
+TrainingReader::TrainingReader() : data(nullptr), size(0), header{} {}
+
+TrainingReader::~TrainingReader() {
+    close();
+}
+
+bool TrainingReader::open(const std::string& path) {
+    close();
+
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "Could not open " << path << std::endl;
+        return false;
+    }
+    struct stat info;
+    if (fstat(fd, &info) < 0 || static_cast<size_t>(info.st_size) < sizeof(FileHeader)) {
+        std::cerr << path << " is not a training export" << std::endl;
+        ::close(fd);
+        return false;
+    }
+    void* mapping = mmap(nullptr, info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (mapping == MAP_FAILED) {
+        std::cerr << "Could not map " << path << std::endl;
+        return false;
+    }
+    data = static_cast<const uint8_t*>(mapping);
+    size = info.st_size;
+    madvise(mapping, size, MADV_SEQUENTIAL);
+
+    std::memcpy(&header, data, sizeof(header));
+    if (std::memcmp(header.magic, FILE_MAGIC, sizeof(header.magic)) != 0 ||
+        header.version != FORMAT_VERSION || header.columnCount != COLUMN_COUNT ||
+        header.boardWidth > 32) {
+        std::cerr << path << " is not a version " << FORMAT_VERSION << " training export" << std::endl;
+        close();
+        return false;
+    }
+
+    // Walk the chunk headers; payloads are skipped, not touched
+    size_t offset = sizeof(FileHeader);
+    while (offset < size) {
+        ChunkView chunk;
+        if (size - offset < sizeof(ChunkHeader)) break;
+        std::memcpy(&chunk.header, data + offset, sizeof(ChunkHeader));
+        offset += sizeof(ChunkHeader);
+
+        const size_t directorySize = sizeof(ColumnEntry) * chunk.header.columnCount;
+        if (std::memcmp(chunk.header.magic, CHUNK_MAGIC, sizeof(chunk.header.magic)) != 0 ||
+            chunk.header.columnCount != COLUMN_COUNT || size - offset < directorySize) {
+            break;
+        }
+        chunk.columns.resize(chunk.header.columnCount);
+        std::memcpy(chunk.columns.data(), data + offset, directorySize);
+        offset += directorySize;
+
+        if (size - offset < chunk.header.payloadSize) break;
+        chunk.payload = data + offset;
+        offset += chunk.header.payloadSize;
+        chunks.push_back(std::move(chunk));
+    }
+    if (offset != size) {
+        std::cerr << path << ": truncated or corrupt chunk at byte " << offset
+                  << ", keeping the " << chunks.size() << " chunks before it" << std::endl;
+    }
+    return true;
+}
+
+void TrainingReader::close() {
+    if (data) {
+        munmap(const_cast<uint8_t*>(data), size);
+    }
+    data = nullptr;
+    size = 0;
+    chunks.clear();
+}
+
+bool TrainingReader::decodeColumn(const ChunkView& chunk, Column column, std::vector<uint8_t>& out) const {
+    if (column >= chunk.columns.size()) return false;
+    const ColumnEntry& entry = chunk.columns[column];
+    if (entry.offset + entry.storedSize > chunk.header.payloadSize) return false;
+
+    const uint8_t* stored = chunk.payload + entry.offset;
+    out.resize(entry.rawSize);
+    if (entry.codec == static_cast<uint8_t>(Codec::Raw)) {
+        if (entry.storedSize != entry.rawSize) return false;
+        std::memcpy(out.data(), stored, entry.rawSize);
+        return true;
+    }
+    if (entry.codec == static_cast<uint8_t>(Codec::Zlib)) {
+        uLongf rawSize = entry.rawSize;
+        return uncompress(out.data(), &rawSize, stored, entry.storedSize) == Z_OK &&
+               rawSize == entry.rawSize;
+    }
+    return false;
+}
+
+} // namespace training
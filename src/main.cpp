@@ -1,10 +1,783 @@
 #include <SDL2/SDL.h>
+#include <algorithm>
+#include <atomic>
 #include <iostream>
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
 #include "BlockDropGame.h"
+#include "ConfigEvaluator.h"
+#include "GameGrid.h"
+#include "LatencyTracker.h"
+#include "NeuralEvaluator.h"
 #include "Renderer.h"
+#include "RollbackRing.h"
+#include "SessionHost.h"
+#include "SdlBackend.h"
+#include "SoftwareBackend.h"
+#include "StreamServer.h"
+#include "TrainingExport.h"
+
+namespace {
+
+struct Options {
+    std::string backend = "sdl";  // sdl, software, null
+    std::string output;           // software backend frame destination
+    std::string format = "raw";   // raw, png
+    long maxFrames = 0;           // 0 = until game over
+    int gridSize = 0;             // Number of concurrent games in grid view
+    int threads = 0;              // Grid, export and A/B worker threads, 0 = one per core
+    bool lowLatency = false;      // Event-driven loop instead of poll-and-sleep
+    bool reportLatency = false;   // Print input latency percentiles on exit
+    std::string streamSocket;     // Unix socket for spectators, empty = off
+    std::string checkpointPath = "blockdrop.ckpt";  // Written by K, read by --resume
+    bool resume = false;
+    std::string exportPath;       // Self-play training data output, empty = off
+    long games = 1000;            // Self-play games for --export
+    std::string scanPath;         // Training export to summarize
+    std::string modelPath;        // Learned evaluator for auto-play, empty = heuristic
+    std::string configPath;       // Weighted-feature evaluator config, reloaded when it changes
+    long abGames = 0;             // Compare --model against the heuristic over N games
+    int boardWidth = BlockDropGame::BOARD_WIDTH;    // Geometry for headless, export and A/B runs
+    int boardHeight = BlockDropGame::BOARD_HEIGHT;
+    long hostSessions = 0;        // Sessions for the --host fleet benchmark
+};
+
+void printUsage(const char* program) {
+    std::cerr << "Usage: " << program << " [options]\n"
+              << "  --backend sdl|software|null  Rendering backend (default: sdl)\n"
+              << "  --output PATH                Frame output for the software backend:\n"
+              << "                               file, '-' for stdout, '|cmd' for a pipe,\n"
+              << "                               or a pattern like frame%05d.png\n"
+              << "  --format raw|png             Frame encoding (default: raw RGBA)\n"
+              << "  --frames N                   Stop a headless run after N frames\n"
+              << "  --grid N                     Watch N auto-play games side by side\n"
+              << "  --threads N                  Worker threads for grid, export and A/B runs\n"
+              << "                               (default: all cores)\n"
+              << "  --low-latency                Wake on input and apply it immediately\n"
+              << "  --latency                    Report input-to-display latency on exit\n"
+              << "  --stream PATH                Publish the game to spectators on a Unix socket\n"
+              << "  --resume PATH                Continue from a checkpoint saved with K\n"
+              << "  --export PATH                Record auto-play self-play games as training data\n"
+              << "  --games N                    Games to play for --export (default: 1000)\n"
+              << "  --scan PATH                  Print the chunk summaries of a training export\n"
+              << "  --model PATH                 Score auto-play moves with a learned evaluator\n"
+              << "  --eval-config PATH           Score auto-play moves with the feature weights in\n"
+              << "                               PATH, picking up edits while running\n"
+              << "  --ab N                       Play N games with --model or --eval-config and N\n"
+              << "                               with the heuristic\n"
+              << "  --board WxH                  Board size for headless, --export and --ab runs\n"
+              << "                               (10, 12, 16 or 32 wide; 20 or 40 tall)\n"
+              << "  --host N                     Host N sessions in one process and report tick\n"
+              << "                               latency (every 4th takes random player input)\n";
+}
+
+bool parseOptions(int argc, char* argv[], Options& options) {
+    for (int i = 1; i < argc; i++) {
+        const char* arg = argv[i];
+        bool hasValue = i + 1 < argc;
+
+        if (std::strcmp(arg, "--backend") == 0 && hasValue) {
+            options.backend = argv[++i];
+        } else if (std::strcmp(arg, "--output") == 0 && hasValue) {
+            options.output = argv[++i];
+        } else if (std::strcmp(arg, "--format") == 0 && hasValue) {
+            options.format = argv[++i];
+        } else if (std::strcmp(arg, "--frames") == 0 && hasValue) {
+            options.maxFrames = std::atol(argv[++i]);
+        } else if (std::strcmp(arg, "--grid") == 0 && hasValue) {
+            options.gridSize = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--threads") == 0 && hasValue) {
+            options.threads = std::atoi(argv[++i]);
+        } else if (std::strcmp(arg, "--low-latency") == 0) {
+            options.lowLatency = true;
+        } else if (std::strcmp(arg, "--latency") == 0) {
+            options.reportLatency = true;
+        } else if (std::strcmp(arg, "--stream") == 0 && hasValue) {
+            options.streamSocket = argv[++i];
+        } else if (std::strcmp(arg, "--resume") == 0 && hasValue) {
+            options.checkpointPath = argv[++i];
+            options.resume = true;
+        } else if (std::strcmp(arg, "--export") == 0 && hasValue) {
+            options.exportPath = argv[++i];
+        } else if (std::strcmp(arg, "--games") == 0 && hasValue) {
+            options.games = std::atol(argv[++i]);
+        } else if (std::strcmp(arg, "--scan") == 0 && hasValue) {
+            options.scanPath = argv[++i];
+        } else if (std::strcmp(arg, "--model") == 0 && hasValue) {
+            options.modelPath = argv[++i];
+        } else if (std::strcmp(arg, "--eval-config") == 0 && hasValue) {
+            options.configPath = argv[++i];
+        } else if (std::strcmp(arg, "--ab") == 0 && hasValue) {
+            options.abGames = std::atol(argv[++i]);
+        } else if (std::strcmp(arg, "--board") == 0 && hasValue) {
+            if (std::sscanf(argv[++i], "%dx%d", &options.boardWidth, &options.boardHeight) != 2) {
+                return false;
+            }
+        } else if (std::strcmp(arg, "--host") == 0 && hasValue) {
+            options.hostSessions = std::atol(argv[++i]);
+        } else {
+            return false;
+        }
+    }
+    return options.backend == "sdl" || options.backend == "software" || options.backend == "null";
+}
+
+std::unique_ptr<RenderBackend> createBackend(const Options& options) {
+    if (options.backend == "sdl") {
+        return std::make_unique<SdlBackend>(Renderer::WINDOW_WIDTH, Renderer::WINDOW_HEIGHT);
+    }
+    if (options.backend == "null") {
+        return std::make_unique<NullBackend>();
+    }
+
+    auto format = SoftwareBackend::OutputFormat::None;
+    if (!options.output.empty()) {
+        format = options.format == "png" ? SoftwareBackend::OutputFormat::PngSequence
+                                         : SoftwareBackend::OutputFormat::RawVideo;
+    }
+    return std::make_unique<SoftwareBackend>(Renderer::WINDOW_WIDTH, Renderer::WINDOW_HEIGHT,
+                                             format, options.output);
+}
+
+// Returns a running stream server if one was requested, nullptr otherwise
+std::unique_ptr<StreamServer> startStream(const Options& options) {
+    if (options.streamSocket.empty()) {
+        return nullptr;
+    }
+    auto server = std::make_unique<StreamServer>(options.streamSocket);
+    if (!server->start()) {
+        return nullptr;
+    }
+    return server;
+}
+
+// Worker threads for grid, export, A/B and host runs
+int workerThreads(const Options& options) {
+    int threads = options.threads > 0 ? options.threads
+                                      : static_cast<int>(std::thread::hardware_concurrency());
+    return std::max(threads, 1);
+}
+
+char mapKey(SDL_Keycode key) {
+    switch (key) {
+        case SDLK_a: return 'a';
+        case SDLK_d: return 'd';
+        case SDLK_s: return 's';
+        case SDLK_w: return 'w';
+        case SDLK_SPACE: return ' ';
+        case SDLK_t: return 't';
+        case SDLK_u: return 'u';
+        case SDLK_k: return 'k';
+        case SDLK_LEFT: return 'a';
+        case SDLK_RIGHT: return 'd';
+        case SDLK_DOWN: return 's';
+        case SDLK_UP: return 'w';
+    }
+    return 0;
+}
+
+// Everything an input can change that ends up on screen
+struct VisibleState {
+    int pieceType, x, y, rotation;
+    int score, linesCleared;
+    bool autoPlay, gameOver;
+
+    bool operator==(const VisibleState& other) const {
+        return pieceType == other.pieceType && x == other.x && y == other.y &&
+               rotation == other.rotation && score == other.score &&
+               linesCleared == other.linesCleared && autoPlay == other.autoPlay &&
+               gameOver == other.gameOver;
+    }
+};
+
+VisibleState captureState(const BlockDropGame& game) {
+    return {static_cast<int>(game.getCurrentPieceType()), game.getCurrentX(), game.getCurrentY(),
+            game.getCurrentRotation(), game.getScore(), game.getLinesCleared(),
+            game.isAutoPlay(), game.isGameOver()};
+}
+
+// Number of inputs that can be undone with U
+const size_t UNDO_DEPTH = 64;
+
+// Where games get their evaluator from: a fixed --model, the newest version of
+// an --eval-config file, or neither for the built-in heuristic. Fetch it with
+// current() when a game starts, or every frame for a single long-running game.
+struct EvaluatorSource {
+    std::shared_ptr<const Evaluator> fixed;
+    std::unique_ptr<ConfigReloader> config;
+
+    std::shared_ptr<const Evaluator> current() const { return config ? config->current() : fixed; }
+    bool isHeuristic() const { return !fixed && !config; }
+};
+
+// `boardHeight` is that of the games the evaluator scores; config thresholds
+// measured from the top depend on it
+bool loadEvaluator(const Options& options, int boardHeight, EvaluatorSource& source) {
+    if (!options.modelPath.empty() && !options.configPath.empty()) {
+        std::cerr << "Use either --model or --eval-config, not both" << std::endl;
+        return false;
+    }
+    if (!options.configPath.empty()) {
+        auto config = std::make_unique<ConfigReloader>(options.configPath, boardHeight);
+        if (!config->load()) {
+            return false;
+        }
+        std::cerr << "Evaluating moves with " << options.configPath << std::endl;
+        source.config = std::move(config);
+        return true;
+    }
+    if (options.modelPath.empty()) {
+        return true;
+    }
+    auto model = std::make_shared<NeuralEvaluator>();
+    if (!model->load(options.modelPath)) {
+        return false;
+    }
+    std::cerr << "Evaluating moves with " << options.modelPath << " ("
+              << model->getKernelName() << ")" << std::endl;
+    source.fixed = std::move(model);
+    return true;
+}
+
+// `evaluators` outlives the call so the run loop can keep fetching from it
+template <typename Game>
+bool loadInitialState(const Options& options, Game& game, EvaluatorSource& evaluators) {
+    if (!loadEvaluator(options, Game::BOARD_HEIGHT, evaluators)) {
+        return false;
+    }
+    game.setEvaluator(evaluators.current());
+    if (options.resume && !game.loadCheckpoint(options.checkpointPath)) {
+        std::cerr << "Could not load checkpoint " << options.checkpointPath << std::endl;
+        return false;
+    }
+    return true;
+}
+
+// Applies one SDL event to the game. Returns true if it was a game input.
+bool processEvent(const SDL_Event& event, BlockDropGame& game, LatencyTracker& tracker,
+                  RollbackRing& history, const Options& options, bool& running) {
+    if (event.type == SDL_QUIT) {
+        running = false;
+        return false;
+    }
+    if (event.type != SDL_KEYDOWN) {
+        return false;
+    }
+
+    SDL_Keycode key = event.key.keysym.sym;
+    if (key == SDLK_q) {
+        running = false;
+        return false;
+    }
+
+    char inputChar = mapKey(key);
+    if (inputChar == 0) {
+        return false;
+    }
+
+    Uint32 ageMs = SDL_GetTicks() - event.key.timestamp;
+    tracker.inputReceived(std::chrono::milliseconds(ageMs));
+
+    VisibleState before = captureState(game);
+    if (inputChar == 'u') {
+        history.undo(game);
+    } else if (inputChar == 'k') {
+        if (!game.saveCheckpoint(options.checkpointPath)) {
+            std::cerr << "Could not save checkpoint " << options.checkpointPath << std::endl;
+        }
+    } else {
+        history.push(game);
+        game.handleInput(inputChar);
+    }
+    tracker.inputHandled(!(captureState(game) == before));
+    return true;
+}
+
+// Sleeps in SDL_WaitEventTimeout until either an input or the next simulation
+// tick is due. Inputs are applied and presented as soon as they arrive instead
+// of waiting for the next poll.
+int runLowLatency(const Options& options) {
+    using Clock = std::chrono::steady_clock;
 
-int main() {
+    Renderer renderer;
+    if (!renderer.initialize()) {
+        std::cerr << "Failed to initialize renderer!" << std::endl;
+        return 1;
+    }
+
+    BlockDropGame game;
+    EvaluatorSource evaluators;
+    if (!loadInitialState(options, game, evaluators)) {
+        return 1;
+    }
+    LatencyTracker tracker;
+    RollbackRing history(UNDO_DEPTH);
+    auto streamServer = startStream(options);
+
+    const auto tickDuration = std::chrono::microseconds(16667);
+    auto lastUpdate = Clock::now();
+    auto nextTick = lastUpdate + tickDuration;
+    bool running = true;
+
+    // Bring gravity and timers up to date before touching the game
+    auto advance = [&]() {
+        auto now = Clock::now();
+        game.update(std::chrono::duration<double>(now - lastUpdate).count());
+        lastUpdate = now;
+    };
+
+    while (running) {
+        auto untilTick = std::chrono::duration_cast<std::chrono::milliseconds>(
+            nextTick - Clock::now() + std::chrono::microseconds(999));
+        int timeoutMs = static_cast<int>(std::max<long long>(0, untilTick.count()));
+
+        bool needsFrame = false;
+        SDL_Event event;
+        if (SDL_WaitEventTimeout(&event, timeoutMs)) {
+            advance();
+            do {
+                needsFrame |= processEvent(event, game, tracker, history, options, running);
+            } while (SDL_PollEvent(&event));
+        }
+
+        if (Clock::now() >= nextTick) {
+            game.setEvaluator(evaluators.current());  // Picks up --eval-config edits
+            advance();
+            nextTick += tickDuration;
+            if (nextTick < lastUpdate) {
+                nextTick = lastUpdate + tickDuration;  // Fell behind, don't try to catch up
+            }
+            needsFrame = true;
+        }
+
+        if (needsFrame) {
+            if (streamServer) streamServer->publish(game);
+            renderer.drawGame(game);
+            tracker.framePresented();
+        }
+    }
+
+    if (options.reportLatency) {
+        tracker.report(std::cerr);
+    }
+    return 0;
+}
+
+template <typename Game>
+struct GameTag {
+    using Type = Game;
+};
+
+// Calls `run` with the GameTag of the --board geometry
+template <typename Run>
+int withBoard(const Options& options, Run run) {
+#define BLOCKDROP_DISPATCH(width, height) \
+    if (options.boardWidth == width && options.boardHeight == height) { \
+        return run(GameTag<BasicBlockDropGame<width, height>>{}); \
+    }
+    BLOCKDROP_GEOMETRIES(BLOCKDROP_DISPATCH)
+#undef BLOCKDROP_DISPATCH
+
+    std::cerr << "Boards of " << options.boardWidth << "x" << options.boardHeight
+              << " are not compiled in" << std::endl;
+    return 1;
+}
+
+// Runs an auto-play game on a fixed 60 Hz timestep as fast as the backend allows
+template <typename Game>
+int runHeadless(const Options& options) {
+    Renderer renderer(createBackend(options));
+    if (!renderer.initialize()) {
+        std::cerr << "Failed to initialize renderer!" << std::endl;
+        return 1;
+    }
+
+    Game game;
+    EvaluatorSource evaluators;
+    if (!loadInitialState(options, game, evaluators)) {
+        return 1;
+    }
+    if (!game.isAutoPlay()) {
+        game.toggleAutoPlay();
+    }
+    auto streamServer = startStream(options);
+
+    const double frameTime = 1.0 / 60.0;
+    long frames = 0;
+    auto startTime = std::chrono::steady_clock::now();
+
+    const RenderBackend& backend = renderer.getBackend();
+    while (!game.isGameOver() && !backend.hasFailed() &&
+           (options.maxFrames <= 0 || frames < options.maxFrames)) {
+        game.setEvaluator(evaluators.current());  // Picks up --eval-config edits
+        game.update(frameTime);
+        if (streamServer) streamServer->publish(game);
+        renderer.drawGame(game);
+        frames++;
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - startTime).count();
+    // Frames may be going to stdout, so report on stderr
+    std::cerr << "Rendered " << frames << " frames in " << elapsed << " s ("
+              << (elapsed > 0.0 ? frames / elapsed : 0.0) << " fps), score "
+              << game.getScore() << ", lines " << game.getLinesCleared() << std::endl;
+
+    renderer.cleanup();
+    return backend.hasFailed() ? 1 : 0;
+}
+
+// Renders a grid of auto-play games advanced by worker threads, paced at 60 FPS
+int runGrid(const Options& options) {
+    Renderer renderer(createBackend(options));
+    if (!renderer.initialize()) {
+        std::cerr << "Failed to initialize renderer!" << std::endl;
+        return 1;
+    }
+
+    GameGrid grid(options.gridSize);
+    grid.start(workerThreads(options));
+
+    const bool windowed = options.backend == "sdl";
+    const auto frameDuration = std::chrono::microseconds(16667);
+    auto nextFrame = std::chrono::steady_clock::now();
+    bool running = true;
+    long frames = 0;
+
+    const RenderBackend& backend = renderer.getBackend();
+    while (running && !backend.hasFailed() && (options.maxFrames <= 0 || frames < options.maxFrames)) {
+        if (windowed) {
+            SDL_Event event;
+            while (SDL_PollEvent(&event)) {
+                if (event.type == SDL_QUIT ||
+                    (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_q)) {
+                    running = false;
+                }
+            }
+        }
+
+        renderer.drawGrid(grid);
+        frames++;
+
+        nextFrame += frameDuration;
+        std::this_thread::sleep_until(nextFrame);
+    }
+
+    grid.stop();
+    renderer.cleanup();
+    return backend.hasFailed() ? 1 : 0;
+}
+
+// Decisions per self-play game before it is cut off; the AI can survive indefinitely
+const uint32_t SELF_PLAY_MOVE_LIMIT = 10000;
+
+// Plays a game to the end the way auto-play would, without the animation.
+// Returns the number of candidate placements scored.
+template <typename Game>
+uint64_t playSelfPlayGame(Game& game, std::vector<BlockDropRules::MoveCandidate>& candidates,
+                          training::ChunkBuilder* builder) {
+    uint64_t placements = 0;
+    // Recorded decisions carry every feature, whichever ones the evaluator reads
+    const uint32_t extraFeatures = builder ? BlockDropRules::ALL_FEATURES : 0;
+    for (uint32_t move = 0; move < SELF_PLAY_MOVE_LIMIT && !game.isGameOver(); move++) {
+        game.evaluateMoves(candidates, extraFeatures);
+        if (candidates.empty()) break;
+        placements += candidates.size();
+
+        // Same choice as auto-play: first candidate with the best score
+        size_t chosen = 0;
+        for (size_t i = 1; i < candidates.size(); i++) {
+            if (candidates[i].score > candidates[chosen].score) chosen = i;
+        }
+        if (builder) {
+            builder->recordDecision(game, candidates, chosen);
+        }
+        game.placeAt(candidates[chosen].x, candidates[chosen].rotation);
+    }
+    return placements;
+}
+
+// Plays seeded auto-play games on worker threads without rendering and records
+// every decision, all candidate placements included, to a training export
+template <typename Game>
+int runExport(const Options& options) {
+    EvaluatorSource evaluators;
+    if (!loadEvaluator(options, Game::BOARD_HEIGHT, evaluators)) {
+        return 1;
+    }
+    training::TrainingWriter writer;
+    const training::Scorer scorer = !options.configPath.empty() ? training::Scorer::Config
+                                  : !options.modelPath.empty() ? training::Scorer::Model
+                                  : training::Scorer::Heuristic;
+    const std::string& scorerName = scorer == training::Scorer::Config ? options.configPath : options.modelPath;
+    if (!writer.open(options.exportPath, Game::BOARD_WIDTH, Game::BOARD_HEIGHT, scorer, scorerName)) {
+        return 1;
+    }
+
+    std::atomic<long> nextGame(0);
+    std::atomic<bool> failed(false);
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < workerThreads(options); t++) {
+        workers.emplace_back([&]() {
+            training::ChunkBuilder builder(writer);
+            std::vector<BlockDropRules::MoveCandidate> candidates;
+
+            long id;
+            while ((id = nextGame.fetch_add(1)) < options.games) {
+                Game game(static_cast<uint64_t>(id) + 1);
+                game.setEvaluator(evaluators.current());
+                builder.beginGame(id);
+                playSelfPlayGame(game, candidates, &builder);
+                builder.endGame(game);
+            }
+            if (!builder.flush()) {
+                failed = true;
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    uint64_t bytes = writer.getBytesWritten();
+    uint64_t records = writer.getRecordsWritten();
+    if (!writer.close() || failed) {
+        return 1;
+    }
+    std::cout << "Exported " << records << " decisions from " << options.games << " games, "
+              << bytes << " bytes in " << elapsed << " s ("
+              << (elapsed > 0.0 ? records / elapsed : 0.0) << " decisions/s)" << std::endl;
+    return 0;
+}
+
+struct PolicyResult {
+    std::atomic<long> score{0};
+    std::atomic<long> lines{0};
+    std::atomic<uint64_t> placements{0};
+    double seconds = 0.0;
+};
+
+// Plays the same seeded games with the evaluators from `evaluators` on worker threads
+template <typename Game>
+void playPolicy(const Options& options, const EvaluatorSource& evaluators, PolicyResult& result) {
+    std::atomic<long> nextGame(0);
+    auto start = std::chrono::steady_clock::now();
+
+    std::vector<std::thread> workers;
+    for (int t = 0; t < workerThreads(options); t++) {
+        workers.emplace_back([&]() {
+            std::vector<BlockDropRules::MoveCandidate> candidates;
+            long id;
+            while ((id = nextGame.fetch_add(1)) < options.abGames) {
+                Game game(static_cast<uint64_t>(id) + 1);
+                game.setEvaluator(evaluators.current());
+                result.placements += playSelfPlayGame(game, candidates, nullptr);
+                result.score += game.getScore();
+                result.lines += game.getLinesCleared();
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+    result.seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+}
+
+// A/B test: the --model or --eval-config evaluator against the built-in
+// heuristic on identical seeds
+template <typename Game>
+int runAbTest(const Options& options) {
+    EvaluatorSource candidate;
+    if (!loadEvaluator(options, Game::BOARD_HEIGHT, candidate)) {
+        return 1;
+    }
+    if (candidate.isHeuristic()) {
+        std::cerr << "--ab needs a --model or --eval-config to compare against the heuristic" << std::endl;
+        return 1;
+    }
+
+    PolicyResult results[2];
+    playPolicy<Game>(options, EvaluatorSource(), results[0]);
+    playPolicy<Game>(options, candidate, results[1]);
+
+    const char* names[2] = {
+        "heuristic", options.modelPath.empty() ? options.configPath.c_str() : options.modelPath.c_str()
+    };
+    for (int i = 0; i < 2; i++) {
+        const PolicyResult& r = results[i];
+        std::cout << names[i] << ": mean score " << static_cast<double>(r.score) / options.abGames
+                  << ", mean lines " << static_cast<double>(r.lines) / options.abGames << ", "
+                  << (r.seconds > 0.0 ? r.placements / r.seconds : 0.0) << " placements/s" << std::endl;
+    }
+    return 0;
+}
+
+// Lists the chunks of a training export from their headers alone
+int runScan(const Options& options) {
+    training::TrainingReader reader;
+    if (!reader.open(options.scanPath)) {
+        return 1;
+    }
+
+    const auto& header = reader.getHeader();
+    const char* scorers[] = {"heuristic", "model", "config"};
+    std::cout << options.scanPath << ": " << header.boardWidth << "x" << header.boardHeight
+              << " boards, " << header.featureCount << " features, scored by "
+              << (header.scorer < 3 ? scorers[header.scorer] : "unknown scorer");
+    if (header.scorerName[0] != '\0') {
+        std::cout << " " << std::string(header.scorerName, strnlen(header.scorerName, sizeof(header.scorerName)));
+    }
+    std::cout << ", " << reader.getChunks().size() << " chunks" << std::endl;
+
+    uint64_t records = 0, candidates = 0, raw = 0, stored = 0;
+    for (size_t i = 0; i < reader.getChunks().size(); i++) {
+        const auto& chunk = reader.getChunks()[i];
+        uint64_t chunkRaw = 0;
+        for (const auto& column : chunk.columns) {
+            chunkRaw += column.rawSize;
+        }
+        std::cout << "chunk " << i << ": " << chunk.header.gameCount << " games (ids "
+                  << chunk.header.minGameId << " to " << chunk.header.maxGameId << "), "
+                  << chunk.header.recordCount << " decisions, "
+                  << chunk.header.candidateCount << " candidates, best score "
+                  << chunk.header.bestFinalScore << ", " << chunk.header.payloadSize << "/"
+                  << chunkRaw << " bytes" << std::endl;
+        records += chunk.header.recordCount;
+        candidates += chunk.header.candidateCount;
+        raw += chunkRaw;
+        stored += chunk.header.payloadSize;
+    }
+    std::cout << "Total: " << records << " decisions, " << candidates << " candidates, "
+              << stored << " bytes stored for " << raw << " raw" << std::endl;
+    return 0;
+}
+
+const long HOST_DEFAULT_TICKS = 600;
+const int HOST_PLAYER_EVERY = 4;  // Every Nth hosted session is a "player" fed random keys
+
+// Fleet benchmark: many sessions in one SessionHost, ticked as fast as the
+// workers allow. Bots that top out are destroyed and replaced; a producer
+// thread plays the part of the network, sending random keys to the players.
+int runHost(const Options& options) {
+    const double tickTime = 1.0 / 60.0;
+    const long ticks = options.maxFrames > 0 ? options.maxFrames : HOST_DEFAULT_TICKS;
+    const int threads = workerThreads(options);
+    const uint32_t count = static_cast<uint32_t>(options.hostSessions);
+    EvaluatorSource evaluators;
+    if (!loadEvaluator(options, SessionHost::Game::BOARD_HEIGHT, evaluators)) {
+        return 1;
+    }
+
+    SessionHost host(count, threads);
+    host.setEvaluator(evaluators.current());
+    std::vector<SessionHandle> players;
+    uint64_t nextSeed = 1;
+    for (uint32_t i = 0; i < count; i++) {
+        bool player = i % HOST_PLAYER_EVERY == 0;
+        SessionHandle handle;
+        host.create(nextSeed++, !player, handle);
+        if (player) players.push_back(handle);
+    }
+    host.start(threads);
+
+    std::atomic<bool> sending(!players.empty());
+    std::atomic<uint64_t> keysSent(0);
+    std::thread producer([&]() {
+        static const char KEYS[] = {'a', 'd', 'w', 's', ' '};
+        std::mt19937 random(1);
+        while (sending.load(std::memory_order_relaxed)) {
+            for (int k = 0; k < 64; k++) {
+                const SessionHandle& handle = players[random() % players.size()];
+                if (host.submitInput(handle, KEYS[random() % sizeof(KEYS)])) keysSent++;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+    });
+
+    std::vector<SessionHandle> finished;
+    long replaced = 0;
+    auto start = std::chrono::steady_clock::now();
+    for (long t = 0; t < ticks; t++) {
+        host.setEvaluator(evaluators.current());  // Picks up --eval-config edits
+        host.tick(tickTime);
+
+        // Recycle finished bots; players keep their handles for the producer
+        finished.clear();
+        host.takeFinished(finished);
+        for (const SessionHandle& handle : finished) {
+            SessionView view;
+            if (host.getSession(handle, view) && view.bot) {
+                SessionHandle fresh;
+                host.destroy(handle);
+                host.create(nextSeed++, true, fresh);
+                replaced++;
+            }
+        }
+    }
+    double elapsed = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+    sending = false;
+    producer.join();
+    host.stop();
+
+    std::cout << "Hosted " << host.size() << " sessions on " << threads << " threads for " << ticks
+              << " ticks in " << elapsed << " s (" << (elapsed > 0.0 ? ticks / elapsed : 0.0)
+              << " ticks/s), " << host.getPiecesPlaced() << " pieces placed, " << replaced
+              << " bots replaced, " << keysSent << " keys sent" << std::endl;
+    host.report(std::cout);
+    return 0;
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    Options options;
+    if (!parseOptions(argc, argv, options)) {
+        printUsage(argv[0]);
+        return 1;
+    }
+    
+    if (!options.scanPath.empty()) {
+        return runScan(options);
+    }
+    const bool classicBoard = options.boardWidth == BlockDropGame::BOARD_WIDTH &&
+                              options.boardHeight == BlockDropGame::BOARD_HEIGHT;
+    if (options.hostSessions > 0) {
+        if (!classicBoard) {
+            std::cerr << "--host runs the classic board only" << std::endl;
+            return 1;
+        }
+        return runHost(options);
+    }
+    if (!options.exportPath.empty()) {
+        return withBoard(options, [&](auto tag) { return runExport<typename decltype(tag)::Type>(options); });
+    }
+    if (options.abGames > 0) {
+        return withBoard(options, [&](auto tag) { return runAbTest<typename decltype(tag)::Type>(options); });
+    }
+    if (options.backend != "sdl" && options.gridSize == 0) {
+        return withBoard(options, [&](auto tag) { return runHeadless<typename decltype(tag)::Type>(options); });
+    }
+    if (!classicBoard) {
+        std::cerr << "--board applies to headless, --export and --ab runs only" << std::endl;
+        return 1;
+    }
+    if (options.gridSize > 0) {
+        return runGrid(options);
+    }
+    if (options.lowLatency) {
+        return runLowLatency(options);
+    }
+    
     Renderer renderer;
     if (!renderer.initialize()) {
         std::cerr << "Failed to initialize renderer!" << std::endl;
@@ -12,6 +785,13 @@ int main() {
     }
     
     BlockDropGame game;
+    EvaluatorSource evaluators;
+    if (!loadInitialState(options, game, evaluators)) {
+        return 1;
+    }
+    LatencyTracker tracker;
+    RollbackRing history(UNDO_DEPTH);
+    auto streamServer = startStream(options);
     
     bool running = true;
     auto lastTime = std::chrono::high_resolution_clock::now();
@@ -23,41 +803,20 @@ int main() {
         
         SDL_Event event;
         while (SDL_PollEvent(&event)) {
-            if (event.type == SDL_QUIT) {
-                running = false;
-            } else if (event.type == SDL_KEYDOWN) {
-                SDL_Keycode key = event.key.keysym.sym;
-                
-                if (key == SDLK_q) {
-                    running = false;
-                } else {
-                    char inputChar = 0;
-                    
-                    switch (key) {
-                        case SDLK_a: inputChar = 'a'; break;
-                        case SDLK_d: inputChar = 'd'; break;
-                        case SDLK_s: inputChar = 's'; break;
-                        case SDLK_w: inputChar = 'w'; break;
-                        case SDLK_SPACE: inputChar = ' '; break;
-                        case SDLK_t: inputChar = 't'; break;
-                        case SDLK_LEFT: inputChar = 'a'; break;
-                        case SDLK_RIGHT: inputChar = 'd'; break;
-                        case SDLK_DOWN: inputChar = 's'; break;
-                        case SDLK_UP: inputChar = 'w'; break;
-                    }
-                    
-                    if (inputChar != 0) {
-                        game.handleInput(inputChar);
-                    }
-                }
-            }
+            processEvent(event, game, tracker, history, options, running);
         }
         
+        game.setEvaluator(evaluators.current());  // Picks up --eval-config edits
         game.update(deltaTime);
+        if (streamServer) streamServer->publish(game);
         renderer.drawGame(game);
+        tracker.framePresented();
         
         SDL_Delay(16); // ~60 FPS
     }
     
+    if (options.reportLatency) {
+        tracker.report(std::cerr);
+    }
     return 0;
 }
\ No newline at end of file
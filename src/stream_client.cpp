@@ -0,0 +1,123 @@
+// Reference spectator for the BlockDrop stream server. Reconstructs the game
+// from the keyframe/delta stream and checks the reconstruction against the
+// hash carried by every periodic keyframe.
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <sys/socket.h>
+#include <sys/un.h>
+#include <unistd.h>
+#include <vector>
+#include "StreamProtocol.h"
+
+namespace {
+
+void printBoard(const stream::GameState& state) {
+    static const char CELL_CHARS[] = ".IOTSZJL";
+    for (int y = 0; y < state.height; y++) {
+        std::cout << '|';
+        for (int x = 0; x < state.width; x++) {
+            std::cout << CELL_CHARS[state.cells[y][x] & 7];
+        }
+        std::cout << "|\n";
+    }
+}
+
+} // namespace
+
+int main(int argc, char* argv[]) {
+    const char* socketPath = nullptr;
+    bool showBoard = false;
+    for (int i = 1; i < argc; i++) {
+        if (std::strcmp(argv[i], "--board") == 0) {
+            showBoard = true;
+        } else {
+            socketPath = argv[i];
+        }
+    }
+    if (!socketPath) {
+        std::cerr << "Usage: " << argv[0] << " [--board] SOCKET_PATH" << std::endl;
+        return 1;
+    }
+
+    sockaddr_un address{};
+    address.sun_family = AF_UNIX;
+    std::strncpy(address.sun_path, socketPath, sizeof(address.sun_path) - 1);
+
+    int fd = socket(AF_UNIX, SOCK_STREAM, 0);
+    if (fd < 0 || connect(fd, reinterpret_cast<sockaddr*>(&address), sizeof(address)) < 0) {
+        std::cerr << "Could not connect to " << socketPath << std::endl;
+        return 1;
+    }
+
+    stream::GameState state{};
+    bool synced = false;
+    uint64_t keyframes = 0, deltas = 0, mismatches = 0, bytes = 0;
+
+    std::vector<uint8_t> buffer;
+    uint8_t chunk[64 * 1024];
+    ssize_t received;
+
+    while ((received = recv(fd, chunk, sizeof(chunk), 0)) > 0) {
+        bytes += received;
+        buffer.insert(buffer.end(), chunk, chunk + received);
+
+        size_t offset = 0;
+        while (buffer.size() - offset >= stream::HEADER_SIZE) {
+            size_t size = buffer[offset] | (buffer[offset + 1] << 8);
+            if (size < stream::HEADER_SIZE || size > stream::MAX_MESSAGE_SIZE) {
+                // The length cannot be trusted, so neither can anything after it
+                std::cerr << "Invalid message length " << size << std::endl;
+                close(fd);
+                return 1;
+            }
+            if (buffer.size() - offset < size) break;
+
+            const uint8_t* message = buffer.data() + offset;
+            offset += size;
+
+            if (!synced && message[2] != static_cast<uint8_t>(stream::MessageType::Keyframe)) {
+                continue;  // Wait for the first keyframe
+            }
+
+            // Hash the reconstruction before a keyframe overwrites it
+            uint64_t reconstructedHash = stream::stateHash(state);
+            stream::MessageType type;
+            uint64_t keyframeHash = 0;
+            if (!stream::decodeMessage(message, size, state, type, keyframeHash)) {
+                std::cerr << "Malformed message of " << size << " bytes" << std::endl;
+                close(fd);
+                return 1;
+            }
+
+            if (type == stream::MessageType::Delta) {
+                deltas++;
+                continue;
+            }
+
+            keyframes++;
+            if (stream::stateHash(state) != keyframeHash) {
+                std::cerr << "tick " << state.tick << ": keyframe hash does not match its contents" << std::endl;
+                mismatches++;
+            } else if (synced && reconstructedHash != keyframeHash) {
+                std::cerr << "tick " << state.tick << ": reconstructed state diverged" << std::endl;
+                mismatches++;
+            } else {
+                std::cout << "tick " << state.tick << ": ok  score " << state.score
+                          << "  level " << state.level << "  lines " << state.linesCleared
+                          << (state.gameOver ? "  GAME OVER" : "") << std::endl;
+            }
+            synced = true;
+
+            if (showBoard) {
+                printBoard(state);
+            }
+        }
+        buffer.erase(buffer.begin(), buffer.begin() + offset);
+    }
+
+    close(fd);
+    std::cout << "Received " << bytes << " bytes: " << keyframes << " keyframes, "
+              << deltas << " deltas, " << mismatches << " mismatches" << std::endl;
+    return mismatches == 0 ? 0 : 2;
+}